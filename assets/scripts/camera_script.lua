@@ -10,25 +10,27 @@ end
 
 function Camera:update(entity, dt)
 	if GetMouseButton(MouseButton.Right) then
-		local translateCam = vec3.new(0, 0, 0)
-		local speed = entity:GetCamera().speed
+		-- plain numbers and translate_view, so moving the camera does not create any userdata
+		local camera = entity:GetCamera()
+		local step = camera.speed * dt
+		local x, y, z = 0, 0, 0
 		if GetKeyboardKey(KeyboardKey.W) then
-			translateCam.z = translateCam.z + speed * dt
+			z = z + step
 		end
 		if GetKeyboardKey(KeyboardKey.S) then
-			translateCam.z = translateCam.z - speed * dt
+			z = z - step
 		end
 		if GetKeyboardKey(KeyboardKey.A) then
-			translateCam.x = translateCam.x + speed * dt
+			x = x + step
 		end
 		if GetKeyboardKey(KeyboardKey.D) then
-			translateCam.x = translateCam.x - speed * dt
+			x = x - step
 		end
 		if GetKeyboardKey(KeyboardKey.Q) then
-			translateCam.y = translateCam.y + speed * dt
+			y = y + step
 		end
 		if GetKeyboardKey(KeyboardKey.E) then
-			translateCam.y = translateCam.y - speed * dt
+			y = y - step
 		end
 
 		--local cameraRotation = GetRotationInRadiansFromMatrix(entity:GetCamera().view)
@@ -41,7 +43,7 @@ function Camera:update(entity, dt)
 
 		--entity:GetCamera().view = rotate(entity:GetCamera().view, cameraRotation.x, vec3.new(1, 0, 0))
 		--entity:GetCamera().view = rotate(entity:GetCamera().view, cameraRotation.y, vec3.new(0, 1, 0))
-		entity:GetCamera().view = translate(entity:GetCamera().view, translateCam)
+		camera:translate_view(x, y, z)
 	end
 end
 
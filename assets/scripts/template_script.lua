@@ -4,10 +4,19 @@ Entity.__index = Entity
 function Entity.new(entity)
 	local o = {}
 	setmetatable(o, Entity)
+	return o
+end
+
+function Entity:init(entity)
+	
 end
 
 function Entity:update(entity, dt)
 	
 end
 
+function Entity:destroy(entity)
+	
+end
+
 return Entity
\ No newline at end of file
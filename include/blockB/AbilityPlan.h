@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "blockB/AbilitySettings.h"
+
+namespace bee
+{
+
+/**
+ * \brief One step of an ability. The AbilitySystem runs every op through a table indexed by it.
+ */
+enum class AbilityOp : uint8_t
+{
+    // when cast
+    ApplyAmountToCaster = 0,
+    ApplyStatusEffectToCaster,
+    StartDash,
+    ScheduleDurationOnCaster,
+    SpawnProjectile,
+    SpawnProjectileCone,
+    SpawnProjectileLine,
+    SpawnAoe,
+
+    // when a player that can be targeted is hit
+    ApplyAmountToHitPlayer,
+    ApplyStatusEffectToHitPlayer,
+    ScheduleDurationOnHitPlayer,
+    StopProjectile,
+
+    // every frame the ability entity is alive
+    AdvanceProjectile,
+    SpawnNextProjectileInLine,
+    DisableAoeCollision,
+
+    Count
+};
+
+/**
+ * \brief A short sequence of ops, sized for the longest sequence CompileAbilityPlan() produces.
+ */
+struct AbilityOpList
+{
+    static constexpr size_t CAPACITY = 4;
+
+    std::array<AbilityOp, CAPACITY> ops = {};
+    uint8_t size = 0;
+
+    void Push(const AbilityOp op) { ops[size++] = op; }
+    [[nodiscard]] const AbilityOp* begin() const { return ops.data(); }
+    [[nodiscard]] const AbilityOp* end() const { return ops.data() + size; }
+};
+
+/**
+ * \brief The settings of an ability resolved into the ops it runs, so the AbilitySystem does not have to look at the
+ * target, cast, apply, instant and shoot types every time the ability is cast, hits or is updated.
+ */
+struct AbilityPlan
+{
+    AbilityOpList castOps;
+    AbilityOpList hitOps;
+    AbilityOpList updateOps;
+
+    // which hit players the hit ops run for
+    bool hitsOtherTeams = false;
+    bool hitsOwnTeam = false;
+    bool hitsCaster = false;
+    // projectiles stop at the first player they hit, an aoe hits everyone inside it
+    bool stopsAtFirstHit = false;
+};
+
+/**
+ * \brief Resolves the settings into a plan. Called by the AbilityManager whenever an ability is added or overridden.
+ */
+AbilityPlan CompileAbilityPlan(const AbilitySettings& ability);
+
+}
@@ -1,8 +1,12 @@
 #pragma once
+#include <cstdint>
 
 namespace bee
 {
 
+// index of an ability in the AbilityManager settings table
+using AbilityID = uint32_t;
+
 enum class Target
 {
     Hostile = 0,
@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <entt/entity/fwd.hpp>
+#include <entt/entity/entity.hpp>
+
+#include "ecs/components/PlayerStatsComponents.h"
+
+namespace bee
+{
+class Input;
+
+/**
+ * \brief Turns the input of the devices into the actions of the players. The bindings of every player are compiled into
+ * a dense table with one keyboard key and one gamepad button per action, so a tick is one pass over the table per
+ * player instead of walking the ability map and the hardcoded movement keys. The result is written to the
+ * PlayerActionsComponent of every player.
+ */
+class ActionMap
+{
+public:
+    /**
+     * \brief Compiles the bindings of the players that changed since the last call, then evaluates every action.
+     */
+    void Update(entt::registry& registry, const Input& input);
+
+    /**
+     * \brief Swaps which players the two keyboard layouts move, players 1 and 2 or players 3 and 4.
+     */
+    void ToggleKeyboardPlayers();
+
+private:
+    static constexpr int MAX_PLAYERS = 4; // one per gamepad
+    static constexpr int16_t NO_BINDING = -1;
+    static constexpr size_t ACTION_COUNT = static_cast<size_t>(PlayerAction::Count);
+
+    struct CompiledBindings
+    {
+        std::array<int16_t, ACTION_COUNT> keys;
+        std::array<int16_t, ACTION_COUNT> buttons;
+
+        // what the table was compiled from
+        entt::entity player = entt::null;
+        uint32_t bindingsRevision = 0;
+        uint32_t layoutRevision = 0;
+    };
+
+    void Compile(
+        CompiledBindings& bindings, int playerID, const AbilitiesOnPlayerComponent* abilities,
+        PlayerActionsComponent& actions) const;
+
+    std::array<CompiledBindings, MAX_PLAYERS> m_bindings = {};
+    bool m_player1and2Input = true;
+    uint32_t m_layoutRevision = 0;
+};
+
+} // namespace bee
@@ -28,7 +28,8 @@ private:
         const PlayerStatsComponent& playerComponent, PlayerStatsComponent::State statusEffect, int& columnIndex);
     void CenteredTitle(const char* title);
     void Info(const PlayerStatsComponent& playerComponent, AbilitiesOnPlayerComponent& abilities);
-    void Edit(PlayerStatsComponent& playerComponent, AbilitiesOnPlayerComponent& abilities);
+    void Edit(
+        PlayerStatsComponent& playerComponent, AbilitiesOnPlayerComponent& abilities, StatModifiersComponent* modifiers);
     void Abilities(const PlayerStatsComponent& playerComponent, AbilitiesOnPlayerComponent& abilities);
     void AbilitiesContent(const PlayerStatsComponent& playerComponent, AbilitiesOnPlayerComponent& abilities);
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "entt/entity/registry.hpp"
 #include "blockB/AbilityCreationMenu.h"
+#include "blockB/ActionMap.h"
 #include "blockB/PlayerStatsWindows.h"
 
 namespace entt {
@@ -25,7 +26,6 @@ private:
 
     AbilityCreationMenu m_abilityCreationMenu;
     PlayerStatsWindows m_playerStatsWindows;
-
-    bool m_player1and2Input = true;
+    ActionMap m_actionMap;
 };
 }
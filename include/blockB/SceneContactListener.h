@@ -1,12 +1,14 @@
 #pragma once
-#include "core/engine.hpp"
-#include "ecs/ECS.h"
+#include <entt/entity/registry.hpp>
 #include "ecs/components/PlayerStatsComponents.h"
 #include "Jolt/Physics/Collision/ContactListener.h"
 
 class SceneContactListener : public JPH::ContactListener
 {
 public:
+    // the world the bodies belong to
+    explicit SceneContactListener(entt::registry& registry) : m_registry(registry) {}
+
     // cannot use JPH::BodyID key because of hash redefinition
     std::unordered_map<std::uint32_t, entt::entity> m_bodyIDToEntity;
 
@@ -26,7 +28,7 @@ public:
     {
         entt::entity player0Ent;
         entt::entity player1Ent;
-        auto& registry = bee::Engine.ECS().Registry();
+        auto& registry = m_registry;
         auto playerView = registry.view<bee::PlayerStatsComponent>();
         for (auto [entity, playerComponent] : playerView.each())
         {
@@ -59,4 +61,7 @@ public:
     //{
     //    bee::Log::Info("A contact was removed");
     //}
+
+private:
+    entt::registry& m_registry;
 };
@@ -56,7 +56,7 @@ public:
     bool Exists(Directory type, const std::string& path);
 
     /// <summary>
-    /// Check the last time a file was modified. Only used on desktop platforms.
+    /// Check the last time a file was modified. Only used on desktop platforms, 0 if the file does not exist.
     /// </summary>
     uint64_t LastModified(Directory type, const std::string& path);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "entt/entity/registry.hpp"
+#include "ecs/WorldContext.h"
 
 namespace bee
 {
@@ -10,7 +11,12 @@ class BaseSystem;
 class ECS
 {
 public:
-    ECS();
+    /**
+     * \brief Creates a world with its own registry and systems. The context is stored in the registry context,
+     * headless worlds only get the systems that gameplay needs.
+     */
+    explicit ECS(const WorldContext& context);
+    ~ECS();
 
     /**
      * \brief Updates all systems.
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace bee
+{
+class AbilityManager;
+class Input;
+class ResourceManager;
+
+/**
+ * \brief What one world needs from the outside, stored in the context of its registry. Systems, Lua bindings and
+ * listeners find it there instead of going through the Engine, so several worlds can live in one process and update on
+ * different threads, sharing the read-only resources.
+ */
+struct WorldContext
+{
+    const AbilityManager* abilityManager = nullptr;
+
+    // meshes and textures, nullptr for headless worlds
+    ResourceManager* resources = nullptr;
+
+    // devices for scripts, nullptr for worlds nobody plays on this machine, their players only act through their
+    // PlayerActionsComponent
+    const Input* input = nullptr;
+
+    // without meshes, hierarchy, editor windows or debug drawing, for worlds that are only simulated
+    bool headless = false;
+};
+
+} // namespace bee
@@ -8,20 +8,20 @@ namespace bee
 struct AbilityComponent
 {
     entt::entity castByPlayer = entt::null;
-    entt::entity hitPlayer = entt::null;
-    AbilitySettings settings;
+    AbilityID abilityID = 0; // settings are looked up in the AbilityManager
     int currentNumberOfProjectiles = 1; // for multiple projectiles shot in a line
     float currentProjectileRange = 0.f;
-    float currentDurationAmount = settings.durationAmount;
-    int currentNumberOfTicks = settings.numberOfTicks;
     bool firstProjectileInLine = false;
     bool dead = false;
-    float currentAoeDuration = settings.aoeDuration;
 
-    explicit AbilityComponent(const entt::entity& argCastByPlayer, const AbilitySettings& argSettings)
-        : castByPlayer(argCastByPlayer), settings(argSettings)
+    explicit AbilityComponent(const entt::entity& argCastByPlayer, const AbilityID argAbilityID)
+        : castByPlayer(argCastByPlayer), abilityID(argAbilityID)
     {
     }
 };
 
+struct PooledAbilityComponent // a dead projectile or aoe entity kept by the AbilitySystem to be reused
+{
+};
+
 }
@@ -1,6 +1,7 @@
 #pragma once
-#include <vector>
+#include <cstdint>
 #include <entt/entity/entity.hpp>
+#include "tools/SmallVector.h"
 
 namespace bee
 {
@@ -8,12 +9,14 @@ namespace bee
 struct HierarchyComponent
 {
     entt::entity parent{entt::null};
-    std::vector<entt::entity> children;
+    SmallVector<entt::entity, 4> children; // the theoretical root is the only node that usually overflows
     bool isSelected = false;
+    uint32_t indexInParent = 0; // position in the children of the parent, set by AttachToParent, not serialized
 
     // if you want an entity to appear in the hierarchy
     // as a child of the theoretical root, the entity must have the RootComponent
-    // and the parent of the new entity and the children of the theoretical root must be updated
+    // and the parent of the new entity and the children of the theoretical root must be updated,
+    // AttachToParent and DetachFromParent in tools/Hierarchy.h do that
 
     //auto theoreticalRootView = registry.view<TheoreticalRootComponent>();
     //auto& rootHierarchyComponent = registry.get<HierarchyComponent>(theoreticalRootView.front());
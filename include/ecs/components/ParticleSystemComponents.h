@@ -1,21 +1,50 @@
 #pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
+#include "tools/Curve.h"
+
 namespace bee
 {
 
+/**
+ * \brief The lifetime curves of an emitter baked into lookup tables. Shared between the emitter and the particles it
+ * spawned, so editing the emitter bakes a new one while the old particles keep theirs.
+ */
+struct ParticleLifetimeCurves
+{
+    BakedCurve<glm::vec4> color;
+    BakedCurve<float> scale;
+};
+
+/**
+ * \brief What a particle does when it hits the ground plane or a physics body.
+ */
+enum class ParticleCollision : uint8_t
+{
+    None,
+    Bounce,
+    Kill
+};
+
 struct ParticleComponent
 {
     float gravity = 1.f;
     glm::vec3 dir = glm::vec3(0.f, 1.f, 0.f);
     float speed = 2.f;
-    glm::vec4 colorBegin = glm::vec4(0.f, 1.f, 1.f, 1.f);
-    glm::vec4 colorEnd = glm::vec4(1.f, 0.f, 1.f, 1.f);
     glm::vec3 scaleBegin = glm::vec3(1.f);
-    glm::vec3 scaleEnd = glm::vec3(0.f);
     float lifeSpan = 2.f;
     float currentLife = lifeSpan;
+    std::shared_ptr<const ParticleLifetimeCurves> curves;
+
+    // copied from the emitter, so colliding doesn't need to look it up
+    ParticleCollision collision = ParticleCollision::None;
+    bool collideWithBodies = false;
+    float groundHeight = 0.f;
+    float restitution = 0.5f;
 };
 
 struct EmptyParticleComponent
@@ -27,6 +56,8 @@ struct EmitterComponent
     float particlesPerSecond = 250.f;
     bool endless = true;
     float lifeSpan = 60.f;
+    // particles are evaluated from their age instead of simulated, see StatelessParticlesComponent
+    bool stateless = false;
 
     float currentLife = lifeSpan;
     float timeSinceLastSpawn = 0.f;
@@ -37,11 +68,41 @@ struct ParticleConfigComponent
     float gravity = 1.f;
     glm::vec3 dir = glm::vec3(0.f, 1.f, 0.f);
     float speed = 2.f;
-    glm::vec4 colorBegin = glm::vec4(0.f, 1.f, 1.f, 1.f);
-    glm::vec4 colorEnd = glm::vec4(1.f, 0.f, 1.f, 1.f);
-    glm::vec3 scaleBegin = glm::vec3(1.f);
-    glm::vec3 scaleEnd = glm::vec3(0.f);
+    // both curves go over the normalized age of a particle, 0 when spawned and 1 when it dies
+    Curve<glm::vec4> colorGradient = {
+        {CurveKey<glm::vec4>{0.f, glm::vec4(0.f, 1.f, 1.f, 1.f)}, CurveKey<glm::vec4>{1.f, glm::vec4(1.f, 0.f, 1.f, 1.f)}}};
+    Curve<float> scaleCurve = {{CurveKey<float>{0.f, 1.f}, CurveKey<float>{1.f, 0.f}}}; // multiplies the spawn scale
     float lifeSpan = 2.f;
+
+    ParticleCollision collision = ParticleCollision::None;
+    bool collideWithBodies = false; // test against the snapshot PhysicsSystem2D publishes, on top of the ground
+    float groundHeight = 0.f;       // the top of the floor in the scene
+    float restitution = 0.5f;       // how much of the speed is kept when bouncing
+
+    // baked from the curves above, rebaked whenever they change
+    std::shared_ptr<const ParticleLifetimeCurves> bakedCurves;
+};
+
+/**
+ * \brief The particles of an emitter in stateless mode. Only the spawn time and seed of every particle are stored, its
+ * position, color and scale are closed-form functions of its age and get evaluated when rendering. Because of that the
+ * particles follow the emitter when it moves and don't collide.
+ */
+struct StatelessParticlesComponent
+{
+    struct Particle
+    {
+        float spawnTime = 0.f;
+        uint32_t seed = 0;
+    };
+
+    std::vector<Particle> particles; // ordered by spawn time, the ones before firstAlive are dead
+    size_t firstAlive = 0;
+
+    float time = 0.f; // clock of the emitter
+    float nextSpawnTime = 0.f;
+    uint32_t spawnCount = 0;
+    uint32_t seed = 0;
 };
 
 }
@@ -1,7 +1,9 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <glm/vec2.hpp>
 #include <entt/entity/entity.hpp>
+#include "tools/SmallVector.h"
 
 namespace bee
 {
@@ -38,6 +40,44 @@ struct CollisionData
     glm::vec2 contactPoint;
 };
 
+/**
+ * \brief What a physics body belongs to. Decides which pairs are checked for overlap and which contacts are published as
+ * events. Abilities never collide with each other.
+ */
+enum class CollisionLayer2D : uint8_t
+{
+    Default = 0,
+    Player,
+    Projectile,
+    AreaOfEffect
+};
+
+/**
+ * \brief An ability body touching a player body.
+ */
+struct AbilityHitEvent2D
+{
+    entt::entity ability;
+    entt::entity player;
+
+    /**
+     * \brief Points away from the player's physics body.
+     */
+    glm::vec2 normal;
+
+    glm::vec2 contactPoint;
+};
+
+/**
+ * \brief The contacts of the last physics update that gameplay reacts to, already filtered by layer pair.
+ * Lives in the registry context and is refilled by PhysicsSystem2D every update, so systems that only care about hits
+ * read a few events instead of walking the collisions of every body.
+ */
+struct CollisionEvents2D
+{
+    std::vector<AbilityHitEvent2D> abilityHits;
+};
+
 /**
  * \brief Physics body for 2D physics system with a disk collider.
  */
@@ -50,8 +90,9 @@ struct PhysicsBody2DComponent
     glm::vec2 position = glm::vec2(0.f);
     glm::vec2 velocity = glm::vec2(0.f);
     float scale = 1.f; // radius of the disk
+    CollisionLayer2D layer = CollisionLayer2D::Default; // not serialized, set by whoever creates the body
 
-    std::vector<CollisionData> collisions = {};
+    SmallVector<CollisionData, 4> collisions;
     void AddCollisionData(const CollisionData& data) { collisions.push_back(data); }
     void ClearCollisionData() { collisions.clear(); }
 
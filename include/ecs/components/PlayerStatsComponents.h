@@ -1,8 +1,13 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <string>
 #include <optional>
+#include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 #include "core/input.hpp"
+#include "blockB/AbilitySettings.h"
+#include "tools/SmallVector.h"
 
 namespace bee
 {
@@ -44,7 +49,7 @@ struct PlayerStatsComponent
     struct VisualEffect
     {
         float duration = 0.2f;
-        float currentDuration = duration;
+        double endTime = 0.0; // in the time of the AbilitySystem, set when the effect is added
         glm::vec4 color = glm::vec4(1.f);
 
         VisualEffect() = default;
@@ -52,7 +57,7 @@ struct PlayerStatsComponent
         explicit VisualEffect(float argDuration, glm::vec4 argColor) : duration(argDuration), color(argColor) {} 
     };
 
-    std::vector<VisualEffect> visualEffects;
+    SmallVector<VisualEffect, 4> visualEffects;
 
     PlayerStatsComponent() = default;
     PlayerStatsComponent(const int argId, const int argTeamId) : id(argId), teamId(argTeamId) {}
@@ -60,12 +65,88 @@ struct PlayerStatsComponent
     bool IsStatusEffectActive(State statusEffect) const { return state & statusEffect; }
 };
 
+using StatModifierHandle = uint32_t;
+
+/**
+ * \brief The buffs, debuffs and permanent changes on the stats of a player that are not used up, like the movement
+ * speed. Health and ammo are pools and are changed directly. The current stats in the PlayerStatsComponent are the
+ * result of the stacks, computed by the AbilitySystem only for the stats that were marked dirty, in a fixed order:
+ * (base + sum of the flat amounts) * (1 + sum of the percentages). Not serialized, a loaded player starts clean.
+ */
+struct StatModifiersComponent
+{
+    static constexpr size_t STAT_COUNT = static_cast<size_t>(Stat::ReceivedDamageReduction) + 1;
+
+    struct Modifier
+    {
+        StatModifierHandle handle = 0;
+        float flat = 0.f;
+        float percentage = 0.f; // 0.1 is +10%
+        bool clampToMax = false; // the stat cannot go above its base while this modifier is active
+    };
+
+    // buffs and debuffs, removed by their handle when their duration ends
+    std::array<SmallVector<Modifier, 2>, STAT_COUNT> stacks;
+    // instant changes and effects over time, they never end so they are merged into one modifier per stat
+    std::array<Modifier, STAT_COUNT> permanent;
+    uint32_t dirtyStats = 0;
+    StatModifierHandle nextHandle = 1; // 0 means no modifier
+
+    void MarkDirty(Stat stat) { dirtyStats |= 1u << static_cast<uint32_t>(stat); }
+    bool IsDirty(Stat stat) const { return dirtyStats & (1u << static_cast<uint32_t>(stat)); }
+};
+
 struct AbilitiesOnPlayerComponent
 {
-    // ability name -> input for the ability (keyboard and controller)
-    std::unordered_map<std::string, std::pair<std::optional<Input::KeyboardKey>, std::optional<Input::GamepadButton>>>
-        abilityNamesToInputsMap;
+    // ability -> input for the ability (keyboard and controller)
+    // serialized by name, since IDs are only stable while the AbilityManager lives
+    std::unordered_map<AbilityID, std::pair<std::optional<Input::KeyboardKey>, std::optional<Input::GamepadButton>>>
+        abilityIDsToInputsMap;
     int maxNumberOfAbilities = 2;
+    // changed by everything that edits the map, so the ActionMap knows when to compile the bindings again
+    uint32_t bindingsRevision = 0;
+};
+
+/**
+ * \brief The most abilities that can be bound to actions at the same time.
+ */
+constexpr int MAX_ABILITY_SLOTS = 8;
+
+enum class PlayerAction : uint8_t
+{
+    MoveLeft = 0,
+    MoveRight,
+    MoveUp,
+    MoveDown,
+    FirstAbility, // followed by the other ability slots, in the order of PlayerActionsComponent::abilitySlots
+    Count = FirstAbility + MAX_ABILITY_SLOTS
+};
+
+using PlayerActionBits = uint32_t;
+static_assert(static_cast<int>(PlayerAction::Count) <= 32, "PlayerActionBits has a bit per action");
+
+/**
+ * \brief What a player does this tick, written by the ActionMap before the systems update. The held bits and the stick
+ * are the whole input of a player, so recording or sending them is enough to play the tick again somewhere else.
+ */
+struct PlayerActionsComponent
+{
+    PlayerActionBits held = 0;
+    PlayerActionBits pressed = 0; // held this tick but not the one before
+    glm::vec2 stick = glm::vec2(0.f); // past the dead zone, -1 to 1 on both axes
+
+    // the ability that every ability slot casts, compiled together with the bindings
+    std::array<AbilityID, MAX_ABILITY_SLOTS> abilitySlots = {};
+    int abilitySlotCount = 0;
+
+    static PlayerActionBits Bit(PlayerAction action) { return 1u << static_cast<uint32_t>(action); }
+    static PlayerAction AbilitySlot(int slot)
+    {
+        return static_cast<PlayerAction>(static_cast<int>(PlayerAction::FirstAbility) + slot);
+    }
+
+    bool IsHeld(PlayerAction action) const { return held & Bit(action); }
+    bool WasPressed(PlayerAction action) const { return pressed & Bit(action); }
 };
 
 }
@@ -1,13 +1,16 @@
 #pragma once
+#include <cstdint>
 #include <string>
-#include <vector>
+#include "tools/SmallVector.h"
 
 namespace bee
 {
 
+using ScriptID = uint32_t;
+
 struct ScriptComponent
 {
-    std::vector<std::string> scripts;
+    SmallVector<std::string, 2> scripts;
 };
 
 }
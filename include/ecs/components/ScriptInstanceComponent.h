@@ -0,0 +1,33 @@
+#pragma once
+#include "ecs/components/ScriptComponent.h"
+#include "sol/sol.hpp"
+#include "tools/SmallVector.h"
+
+namespace bee
+{
+
+/**
+ * \brief The Lua objects of the scripts of an entity, made by the ScriptSystem once and kept for as long as the entity
+ * has its ScriptComponent, so scripts can keep state between frames. Added and removed together with the
+ * ScriptComponent, not saved.
+ */
+struct ScriptInstanceComponent
+{
+    struct Instance
+    {
+        ScriptID script = 0;
+
+        // the script worker whose Lua state the object and entity live in, -1 for the main state
+        int worker = -1;
+
+        // what the new function of the script returned, invalid if the script failed to load or to create it
+        sol::table object;
+
+        // the EntityLua passed to the script, made once so calling the script does not allocate
+        sol::object entity;
+    };
+
+    SmallVector<Instance, 2> instances;
+};
+
+}
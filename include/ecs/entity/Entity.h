@@ -8,7 +8,8 @@ class Entity
 {
 public:
     Entity() = default;
-    explicit Entity(entt::entity entity);
+    // the world the entity lives in, there can be more than one
+    Entity(entt::registry& registry, entt::entity entity);
     
     template<typename T>
     T& GetComponent();
@@ -24,6 +25,7 @@ public:
     explicit operator uint32_t() const { return static_cast<uint32_t>(m_entity); }
 
 private:
+    entt::registry* m_registry = nullptr;
 	entt::entity m_entity{ entt::null };
 };
 
@@ -1,29 +1,100 @@
 #pragma once
+#include <array>
 #include <map>
 #include <glm/vec4.hpp>
 #include <string>
 
 #include "BaseSystem.h"
+#include "blockB/AbilityPlan.h"
+#include "blockB/AbilitySettings.h"
+#include "ecs/components/PhysicsBody2DComponent.h"
+#include "ecs/components/PlayerStatsComponents.h"
+#include "ecs/WorldContext.h"
+#include "tools/TimingWheel.h"
 
 namespace bee
 {
-enum class Stat;
-enum class IncreaseOrDecrease;
-struct PlayerStatsComponent;
 struct MeshComponent;
-struct PhysicsBody2DComponent;
 struct TransformComponent;
-struct AbilitySettings;
 struct AbilityComponent;
+class AbilityManager;
 
 class AbilitySystem final : public BaseSystem
 {
 public:
+    /**
+     * \brief The abilities and resources come from the WorldContext in the registry context.
+     */
     explicit AbilitySystem(entt::registry& registry);
 
     void Update(const float& dt) override;
 
+    /**
+     * \brief Casts the ability if the player has the ammo for it. Called for the ability actions of the players.
+     */
+    void CreateAbility(AbilityID abilityID, entt::entity castByPlayer);
+
 private:
+    /**
+     * \brief What ApplyAmount did, so RevertAmount can undo exactly that once a buff or debuff ends.
+     */
+    struct AppliedAmount
+    {
+        StatModifierHandle handle = 0; // the modifier pushed on a stat that is not a pool
+        float delta = 0.f;             // the change of a pool stat, after clamping
+    };
+
+    /**
+     * \brief Something that happens a set time after an ability took effect.
+     */
+    struct TimedEffect
+    {
+        enum class Type : uint8_t
+        {
+            Tick, // the next tick of an effect over time
+            Revert, // the end of a buff or debuff
+            StatusEffectEnd,
+            DashEnd,
+            AoeEnd, // the aoe stops being displayed
+            VisualEffectEnd
+        };
+
+        Type type = Type::Tick;
+        double time = 0.0;
+        AbilityID abilityID = 0;
+        entt::entity castByPlayer = entt::null;
+        entt::entity target = entt::null; // the affected player, or the aoe entity for AoeEnd
+        int remainingTicks = 0;
+        AppliedAmount applied; // for Revert
+    };
+
+    /**
+     * \brief What the ops of an ability work on. Cast ops only get the caster, update ops also the ability entity and
+     * hit ops also the hit player.
+     */
+    struct OpContext
+    {
+        AbilityID abilityID = 0;
+        const AbilitySettings* ability = nullptr;
+        entt::entity castByPlayer = entt::null;
+        PlayerStatsComponent* castByPlayerStats = nullptr;
+        entt::entity abilityEntity = entt::null;
+        AbilityComponent* abilityComponent = nullptr;
+        entt::entity hitPlayer = entt::null;
+        PlayerStatsComponent* hitPlayerStats = nullptr;
+        float dt = 0.f;
+        AppliedAmount applied; // set by the apply amount ops, for the duration ops after them
+    };
+
+    WorldContext m_context; // a copy, other context variables can move it around
+    const AbilityManager& m_abilityManager;
+    bool m_headless = false;
+
+    // durations are scheduled in this time instead of being counted down every frame,
+    // so the cost per frame depends on the effects that end, not on the ones that are active
+    double m_time = 0.0;
+    TimingWheel<TimedEffect> m_timedEffects;
+
     std::vector<glm::vec4> m_teamColors = {
         {0.5f, 0.75f, 1.f, 1.f}, // 0
         {1.f, 0.5f, 0.75f, 1.f}, // 1
@@ -39,7 +110,26 @@ private:
     glm::vec4 m_stunRootSilenceColor = {0.5f, 0.5f, 0.5f, 1.f}; // grey
     glm::vec4 m_invincibilityColor = {1.f, 1.f, 0.f, 1.f};      // yellow
 
-    void UpdateAmmoAndDisplayVisualEffects(float dt);
+    // copy of the ability hits published by the physics system, sorted by ability
+    std::vector<AbilityHitEvent2D> m_abilityHits;
+
+    // dead projectiles and aoes keep their entity, hierarchy and name component, so spawning a cone of projectiles
+    // does not have to create the entities and grow the storages again
+    std::vector<entt::entity> m_abilityPool;
+    entt::entity m_theoreticalRoot = entt::null;
+
+    void UpdateAmmo(float dt);
+
+    void UpdateTimedEffects(float dt);
+
+    void FireTimedEffect(const TimedEffect& timedEffect);
+
+    /**
+     * \brief Schedules the tick, revert or end of an ability that was just applied, if it has a duration.
+     */
+    void ScheduleDurationalEffect(
+        AbilityID abilityID, const AbilitySettings& ability, entt::entity castByPlayer, entt::entity hitPlayer,
+        const AppliedAmount& applied);
 
     void UpdateAbilities(float dt);
 
@@ -47,27 +137,78 @@ private:
 
     void DisplayVisualEffectsEditor();
 
-    void CreateAbility(const std::string& abilityName, entt::entity castByPlayer);
+    /**
+     * \brief Runs the ops in order, through m_opTable. Stops early if an op releases the ability entity.
+     */
+    void RunOps(const AbilityOpList& ops, OpContext& context);
+
+    // one function per AbilityOp
+    void ApplyAmountToCasterOp(OpContext& context);
+    void ApplyStatusEffectToCasterOp(OpContext& context);
+    void StartDashOp(OpContext& context);
+    void ScheduleDurationOnCasterOp(OpContext& context);
+    void SpawnProjectileOp(OpContext& context);
+    void SpawnProjectileConeOp(OpContext& context);
+    void SpawnProjectileLineOp(OpContext& context);
+    void SpawnAoeOp(OpContext& context);
+    void ApplyAmountToHitPlayerOp(OpContext& context);
+    void ApplyStatusEffectToHitPlayerOp(OpContext& context);
+    void ScheduleDurationOnHitPlayerOp(OpContext& context);
+    void StopProjectileOp(OpContext& context);
+    void AdvanceProjectileOp(OpContext& context);
+    void SpawnNextProjectileInLineOp(OpContext& context);
+    void DisableAoeCollisionOp(OpContext& context);
 
-    std::pair<float&, float&> GetStat(Stat stat, PlayerStatsComponent& playerStats);
+    /**
+     * \brief Fills in the components of a projectile shot by the caster in the direction they are facing.
+     */
+    void PrepareProjectile(
+        const OpContext& context, MeshComponent& meshComponent, PhysicsBody2DComponent& physicsBody,
+        TransformComponent& transformComponent);
 
     /**
-     * \brief Applies the amount based on stat type, increase or decrease and apply type.
+     * \brief Applies the amount based on stat type, increase or decrease and apply type. Health and ammo are changed
+     * directly, the other stats get a modifier and are recomputed in RefreshDirtyStats().
      * \param ability Ability data.
+     * \param hitPlayer The player to modify.
      * \param hitPlayerStats The player stats to modify.
      * \param castByPlayerStats The player who cast the ability (for now only used for the damage modifier).
-     * \param revert To revert the effect of the ability - for example after an ability with a duration ends.
+     * \return What was applied, to revert it after an ability with a duration ends.
+     */
+    AppliedAmount ApplyAmount(
+        const AbilitySettings& ability, entt::entity hitPlayer, PlayerStatsComponent& hitPlayerStats,
+        const PlayerStatsComponent& castByPlayerStats);
+
+    /**
+     * \brief Undoes what ApplyAmount applied, for example after an ability with a duration ends.
+     */
+    void RevertAmount(
+        const AbilitySettings& ability, entt::entity player, PlayerStatsComponent& playerStats,
+        const AppliedAmount& applied);
+
+    /**
+     * \brief Recomputes the current stats whose modifiers changed since the last call.
      */
-    void ApplyAmount(
-        const AbilitySettings& ability, PlayerStatsComponent& hitPlayerStats,
-        const PlayerStatsComponent& castByPlayerStats, bool revert);
+    void RefreshDirtyStats();
 
-    void ApplyStatusEffect(const AbilitySettings& ability, PlayerStatsComponent& playerStats);
+    void ApplyStatusEffect(const AbilitySettings& ability, entt::entity player, PlayerStatsComponent& playerStats);
+
+    entt::entity GetTheoreticalRoot();
 
     void AddToHierarchy(entt::entity entity, const std::string& name);
 
     void RemoveFromHierarchy(entt::entity entity);
 
+    /**
+     * \brief Takes an entity from the pool, or creates one if the pool is empty.
+     */
+    entt::entity TakeFromPool();
+
+    /**
+     * \brief Strips a dead projectile or aoe down to its hierarchy and name component and puts it in the pool.
+     */
+    void ReleaseToPool(entt::entity entity);
+
     entt::entity CreateProjectile(const AbilityComponent& abilityComponent, const MeshComponent& meshComponent,
         const PhysicsBody2DComponent& physicsBody, const TransformComponent& transformComponent);
 
@@ -75,9 +216,38 @@ private:
 
     void ProjectilesInLineLogic(entt::entity ability, AbilityComponent& abilityComponent);
 
-    void AddVisualEffectForApplyAmount(const AbilitySettings& ability, PlayerStatsComponent& playerStats);
+    void AddVisualEffectForApplyAmount(const AbilitySettings& ability, entt::entity player, PlayerStatsComponent& playerStats);
+
+    void AddVisualEffectForStatusEffect(const AbilitySettings& ability, entt::entity player, PlayerStatsComponent& playerStats);
+
+    void AddVisualEffect(
+        entt::entity player, PlayerStatsComponent& playerStats, PlayerStatsComponent::VisualEffect visualEffect);
 
-    void AddVisualEffectForStatusEffect(const AbilitySettings& ability, PlayerStatsComponent& playerStats);
+    /**
+     * \brief Removes the visual effects that ended by the time and shows the color of the newest one left.
+     */
+    void RemoveEndedVisualEffects(entt::entity player, PlayerStatsComponent& playerStats, double time);
+
+    using OpFunction = void (AbilitySystem::*)(OpContext&);
+
+    // indexed by AbilityOp, in the same order
+    const std::array<OpFunction, static_cast<size_t>(AbilityOp::Count)> m_opTable = {
+        &AbilitySystem::ApplyAmountToCasterOp,
+        &AbilitySystem::ApplyStatusEffectToCasterOp,
+        &AbilitySystem::StartDashOp,
+        &AbilitySystem::ScheduleDurationOnCasterOp,
+        &AbilitySystem::SpawnProjectileOp,
+        &AbilitySystem::SpawnProjectileConeOp,
+        &AbilitySystem::SpawnProjectileLineOp,
+        &AbilitySystem::SpawnAoeOp,
+        &AbilitySystem::ApplyAmountToHitPlayerOp,
+        &AbilitySystem::ApplyStatusEffectToHitPlayerOp,
+        &AbilitySystem::ScheduleDurationOnHitPlayerOp,
+        &AbilitySystem::StopProjectileOp,
+        &AbilitySystem::AdvanceProjectileOp,
+        &AbilitySystem::SpawnNextProjectileInLineOp,
+        &AbilitySystem::DisableAoeCollisionOp,
+    };
 };
 }
 
@@ -1,6 +1,16 @@
 #pragma once
 #include "BaseSystem.h"
 #include "ecs/components/MeshComponent.h"
+#include "tools/Random.h"
+
+namespace bee
+{
+struct ParticleConfigComponent;
+struct ParticleComponent;
+struct TransformComponent;
+struct StatelessParticlesComponent;
+class PhysicsGridSnapshot2D;
+}
 
 namespace bee
 {
@@ -13,11 +23,28 @@ public:
     void Update(const float& dt) override;
     void Render() const override;
 
+    /**
+     * \brief Skips a stateless emitter ahead, e.g. to pre-warm it or after it was off-screen.
+     * Costs the same no matter how far ahead it skips, the particles that would have died in between are never created.
+     * \param emitter An emitter with EmitterComponent::stateless set.
+     * \param seconds How far to skip.
+     */
+    void FastForward(entt::entity emitter, float seconds);
+
 private:
     void CreateEmitter(const MeshComponent& mesh) const;
-    void AddParticle(const entt::entity& emitter) const;
-    void UpdateOneStep(const float& dt) const;
+    void AddParticle(const entt::entity& emitter, const glm::vec2& spread);
+    void UpdateOneStep(const float& dt);
+    void AdvanceStatelessEmitter(entt::entity emitter, float dt);
+    void RenderStatelessParticles() const;
+    /**
+     * \brief Resolves collisions with the ground and, if enabled, the physics bodies.
+     * \return False if the particle got killed.
+     */
+    static bool Collide(
+        ParticleComponent& particle, TransformComponent& transform, const PhysicsGridSnapshot2D* physicsSnapshot);
     void UpdateAtFixedTS(const float& dt);
+    void BakeCurves(ParticleConfigComponent& particleConfig) const;
     void ImGuiWindow();
 
     MeshComponent m_mesh;
@@ -27,6 +54,10 @@ private:
     bool m_fixedTimeStep = false;
     float m_timeStep = 1.f / 30.f;
     float m_accumulator = 0.f;
+
+    // own stream so spawning is reproducible and never shares state with other systems or threads
+    RandomStream m_random = RandomStream(0x9e3779b97f4a7c15ull, 1);
+    std::vector<float> m_spreadBuffer;
 };
 
 } // namespace bee
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <entt/entity/fwd.hpp>
+
+namespace bee
+{
+
+/**
+ * \brief Read-only copy of the 2D physics bodies, bucketed in a uniform grid on the XZ plane.
+ * PhysicsSystem2D rebuilds it at the end of its update, when a PhysicsGridSnapshotRequest2D asks for it, and stores it in
+ * the registry context, so other systems can do coarse queries against the world without touching the physics bodies or
+ * the registry.
+ */
+class PhysicsGridSnapshot2D
+{
+public:
+    /**
+     * \brief A physics body as a vertical cylinder, the disk collider extruded over the height of its transform.
+     */
+    struct Body
+    {
+        glm::vec2 position = glm::vec2(0.f);
+        float radius = 0.f;
+        float bottom = 0.f;
+        float top = 0.f;
+    };
+
+    /**
+     * \brief Copies all physics bodies that have a transform and buckets them.
+     */
+    void Rebuild(entt::registry& registry);
+
+    /**
+     * \brief Finds a body the point is inside of.
+     * \param point The point in world space.
+     * \return The first body found, or nullptr.
+     */
+    [[nodiscard]] const Body* FindBody(const glm::vec3& point) const;
+
+private:
+    std::vector<Body> m_bodies;
+
+    // bodies per cell in compressed rows, the bodies of cell i are m_cellBodies[m_cellStart[i], m_cellStart[i + 1])
+    std::vector<uint32_t> m_cellStart;
+    std::vector<uint32_t> m_cellBodies;
+
+    glm::vec2 m_origin = glm::vec2(0.f);
+    float m_inverseCellSize = 1.f;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+/**
+ * \brief Stored in the registry context by the systems that read the PhysicsGridSnapshot2D, which set requested every
+ * frame they need it. PhysicsSystem2D only rebuilds the snapshot while it is requested and removes it otherwise, so
+ * the physics update costs nothing extra when nobody reads it.
+ */
+struct PhysicsGridSnapshotRequest2D
+{
+    bool requested = false;
+};
+
+} // namespace bee
@@ -1,26 +1,45 @@
 #pragma once
+#include <vector>
 #include "BaseSystem.h"
 
 namespace bee
 {
 struct PhysicsBody2DComponent;
 struct CollisionData;
+struct CollisionEvents2D;
 
 class PhysicsSystem2D final : public BaseSystem
 {
 public:
-    PhysicsSystem2D(entt::registry& registry);
+    /**
+     * \brief Headless worlds, see the WorldContext in the registry context, skip the grid snapshot and the debug drawing.
+     */
+    explicit PhysicsSystem2D(entt::registry& registry);
 
     void Update(const float& dt) override;
 
 private:
     void UpdateTransforms(float dt);
     void CheckAndRegisterCollisions();
+    void PublishSnapshot();
     void DebugDrawing();
 
     bool CheckAndRegisterCollision(
         const entt::entity& entity1, PhysicsBody2DComponent& body1, const entt::entity& entity2, PhysicsBody2DComponent& body2,
         CollisionData& collision);
+
+    /**
+     * \brief Checks a pair and publishes the contact as an event if the layers of the pair are ones gameplay listens to.
+     */
+    void CheckPair(
+        const entt::entity& entity1, PhysicsBody2DComponent& body1, const entt::entity& entity2, PhysicsBody2DComponent& body2,
+        CollisionEvents2D& events);
+
+    // bodies split by layer every update, reused between updates to avoid allocations
+    std::vector<std::pair<entt::entity, PhysicsBody2DComponent*>> m_abilityBodies;
+    std::vector<std::pair<entt::entity, PhysicsBody2DComponent*>> m_otherBodies;
+
+    bool m_headless = false;
 };
 
 } //namespace bee
\ No newline at end of file
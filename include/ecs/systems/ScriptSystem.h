@@ -1,6 +1,20 @@
 #pragma once
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include "BaseSystem.h"
+#include "ecs/components/ScriptComponent.h"
+#include "ecs/components/ScriptInstanceComponent.h"
+#include "scripting/LuaAllocator.h"
+#include "scripting/LuaProfiler.h"
+#include "scripting/ScriptScheduler.h"
+#include "scripting/StagedComponents.h"
 #include "sol/sol.hpp"
+#include "tools/FileWatcher.h"
 
 // For explanations on how scripts should be written and used,
 // please refer to the README file in the assets/scripts folder.
@@ -12,14 +26,268 @@ class ScriptSystem : public BaseSystem
 public:
     explicit ScriptSystem(entt::registry& registry);
 
+    /**
+     * \brief Stops the workers and releases the instances of the scripts while the Lua states still exist. Their
+     * destroy functions are not called, the whole world is going away.
+     */
+    ~ScriptSystem() override;
+
     /**
      * \brief Runs all scripts.
      * \param dt delta time
      */
     void Update(const float& dt) override;
 
+    /**
+     * \brief Gets the ID of a script path, the same path always gets the same ID.
+     */
+    ScriptID Intern(const std::string& path);
+
+    /**
+     * \brief Compiles a script that is in use again and points its instances to the new functions, keeping their
+     * fields. If the new version fails to load, the previous one keeps running. Called for every script that changes
+     * in assets/scripts.
+     */
+    void ReloadScript(const std::string& path);
+
+    /**
+     * \brief Reloads every script that is in use.
+     */
+    void ReloadAllScripts();
+
+    /**
+     * \brief Sets how long the garbage collector of every Lua state may run at the end of an update. The collectors
+     * only run there, in steps, instead of whenever Lua allocates. A state whose memory runs away from the collector
+     * finishes its cycle whatever the budget.
+     * \param seconds Only used in incremental mode, a generational step cannot be split.
+     */
+    void SetGarbageCollectionBudget(float seconds) { m_garbageCollectionBudget = seconds; }
+
+    /**
+     * \brief Switches the collectors between incremental mode, which spreads every cycle over several updates within
+     * the budget, and generational mode, which does one young collection in the updates where memory grew enough.
+     */
+    void SetGenerationalGarbageCollection(bool generational);
+
+    /**
+     * \return The memory of the main state and of the workers together.
+     */
+    [[nodiscard]] LuaAllocator::Stats GetMemoryStats() const;
+
 private:
-    sol::state m_lua;
+    /**
+     * \brief A script file run once, what it returned is kept until the script is reloaded.
+     */
+    struct CachedScript
+    {
+        std::string path;
+        sol::table type;
+        sol::protected_function create;
+
+        // a script has update, update_all or both, update_all is called instead of update
+        sol::protected_function update;
+        sol::protected_function updateAll;
+
+        // optional, invalid if the script does not have them
+        sol::protected_function init;
+        sol::protected_function destroy;
+
+        // the instances and entities passed to update_all, filled every frame and kept to not allocate new tables
+        sol::table batchInstances;
+        sol::table batchEntities;
+        int batchSize = 0;
+        int previousBatchSize = 0;
+
+        // set to true in the type, the instances of the script then run in the worker states, in parallel
+        bool parallelSafe = false;
+
+        bool loaded = false;
+        bool valid = false;
+    };
+
+    /**
+     * \brief A Lua state with the bindings and the scripts that were loaded in it.
+     */
+    struct ScriptState
+    {
+        // closed before its memory is released
+        LuaAllocator allocator;
+
+        // destroyed after the scripts that reference it
+        sol::state lua = sol::state(sol::default_at_panic, &LuaAllocator::Allocate, &allocator);
+
+        // how much memory the objects that survived the last cycle take, the next cycle starts once the memory in
+        // use has grown enough past it
+        size_t collectedBytes = 0;
+        bool collecting = false;
+
+        // LuaAllocator::Stats::allocatedBytes when the cycle started, what was allocated during the cycle is not
+        // counted as surviving it
+        uint64_t cycleStartAllocatedBytes = 0;
+
+        // removes its hook and allocator before the state is closed, only the one of the main state is shown
+        LuaProfiler profiler = LuaProfiler(lua.lua_state());
+
+        // indexed by ScriptID
+        std::vector<CachedScript> scripts;
+    };
+
+    /**
+     * \brief A state for the parallel safe scripts of some chunks of entities. The scripts see copies of the
+     * components, which are written back once every worker is done.
+     */
+    struct Worker
+    {
+        ScriptState state;
+        StagedComponents staged;
+
+        // the instances to update this frame, gathered before the workers start
+        std::vector<const ScriptInstanceComponent::Instance*> jobs;
+
+        // the first worker has no thread, it runs on the thread that updates the system
+        std::thread thread;
+    };
+
+    /**
+     * \brief Registers the engine bindings in a state. Without staged, the scripts of the state change the registry
+     * directly.
+     */
+    void Bind(ScriptState& state, StagedComponents* staged);
+
+    /**
+     * \brief Runs the garbage collector of a state for at most the budget, if the state has a cycle to do.
+     * \return How long the collector ran, in seconds.
+     */
+    float CollectGarbage(ScriptState& state) const;
+
+    /**
+     * \brief Loads the script in a state the first time it is asked for.
+     * \return The script, or nullptr if it failed to load. A failed script is not tried again until it is reloaded.
+     */
+    CachedScript* Load(ScriptState& state, ScriptID id);
+
+    /**
+     * \brief Runs the file of a script and takes its functions.
+     * \return False if the file failed to run or the script is missing a function, the error is logged.
+     */
+    static bool Compile(sol::state& lua, CachedScript& script);
+
+    /**
+     * \brief Compiles a script that was loaded in a state again.
+     * \return False if the new version failed and the previous one is kept.
+     */
+    bool ReloadIn(ScriptState& state, ScriptID id);
+
+    /**
+     * \brief Updates one instance, or adds it to the batch of its script if the script has update_all.
+     */
+    void UpdateInstance(ScriptState& state, const ScriptInstanceComponent::Instance& instance, float dt);
+
+    /**
+     * \brief Calls update_all once for every script of a state that has it, with the instances gathered during the
+     * update.
+     */
+    static void UpdateBatches(ScriptState& state, float dt);
+
+    /**
+     * \brief Gives every instance of a reloaded script the new type as its metatable, instances that failed to be
+     * made before are made now.
+     */
+    void SwapInstances(ScriptID id);
+
+    /**
+     * \brief The state an instance lives in.
+     */
+    ScriptState& StateOf(const ScriptInstanceComponent::Instance& instance);
+
+    /**
+     * \brief The worker that runs the parallel safe scripts of an entity. Entities are split in chunks of
+     * consecutive indices, which go to the workers in turn.
+     */
+    [[nodiscard]] int WorkerOf(entt::entity entity) const;
+
+    /**
+     * \brief Makes a worker for every core the first time a parallel safe script is used.
+     */
+    void StartWorkers();
+    void StopWorkers();
+
+    /**
+     * \brief Runs the jobs of every worker at the same time and writes the changed components back once all are done.
+     */
+    void UpdateWorkers(float dt);
+
+    /**
+     * \brief Writes the staged components of a worker back to the registry, only when no worker runs.
+     */
+    void ApplyStaged(int worker);
+
+    /**
+     * \brief Updates the gathered instances of a worker, on the thread of the worker.
+     */
+    void RunWorker(Worker& worker, float dt);
+
+    /**
+     * \brief What the thread of a worker does, waits for a frame to start and runs the worker until the system stops
+     * it.
+     */
+    void WorkerLoop(Worker& worker);
+
+    /**
+     * \brief Replaces the instances of an entity with new ones for every script in its ScriptComponent.
+     */
+    void CreateInstances(
+        entt::entity entity, const ScriptComponent& scriptComponent, ScriptInstanceComponent& instanceComponent);
+
+    /**
+     * \brief Calls the new and init functions of the script of an instance.
+     */
+    void CreateInstance(entt::entity entity, ScriptInstanceComponent::Instance& instance);
+
+    /**
+     * \brief Calls the destroy function of every instance of an entity and releases them.
+     */
+    void DestroyInstances(ScriptInstanceComponent& instanceComponent);
+
+    void OnScriptComponentConstruct(entt::registry& registry, entt::entity entity);
+    void OnScriptComponentDestroy(entt::registry& registry, entt::entity entity);
+    void OnScriptInstanceComponentDestroy(entt::registry& registry, entt::entity entity);
+
+    // entities with consecutive indices that go to the same worker, so a worker reads components close together
+    static constexpr uint32_t WORKER_CHUNK_SIZE = 64;
+
+    // how much the memory of a state grows after a collection before the next one starts, Lua's defaults
+    static constexpr size_t INCREMENTAL_PAUSE_PERCENT = 200;
+    static constexpr size_t GENERATIONAL_GROWTH_PERCENT = 120;
+
+    // growth at which a full collection is done even if it goes over the budget
+    static constexpr size_t RUNAWAY_PERCENT = 400;
+
+    float m_garbageCollectionBudget = 0.001f;
+    bool m_generationalGarbageCollection = false;
+
+    // the time the collector of the main state took in the last update
+    float m_garbageCollectionSeconds = 0.f;
+
+    // runs every script that is not parallel safe, the paths of all scripts are kept in its CachedScripts
+    ScriptState m_main;
+
+    ScriptScheduler m_scheduler = ScriptScheduler(m_main.lua, m_registry);
+
+    std::unordered_map<std::string, ScriptID> m_ids;
+
+    // empty until a parallel safe script is used
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // guards the fields below, which tell the threads of the workers when to run
+    std::mutex m_workMutex;
+    std::condition_variable m_workStarted;
+    std::condition_variable m_workFinished;
+    uint64_t m_workFrame = 0;
+    size_t m_busyWorkers = 0;
+    float m_workDt = 0.f;
+    bool m_stopWorkers = false;
 
+    FileWatcher m_watcher = FileWatcher("assets/scripts/", ".lua");
 };
 }
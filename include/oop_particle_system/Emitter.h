@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "platform/opengl/uniforms_gl.hpp"
+#include "tools/Random.h"
 
 namespace bee
 {
@@ -13,7 +14,6 @@ class DebugRenderer;
 
 struct Particle
 {
-    bool active = false;
     vec3 pos = vec3(0.f);
     vec3 velocity = vec3(0.f, 1.f, 0.f) * 5.f;  // dir + speed
     vec4 color = vec4(1.f);
@@ -28,7 +28,7 @@ public:
     Emitter(bee::SimpleRenderer* simpleRenderer);
     ~Emitter() = default;
 
-    void AddParticle();
+    void AddParticle(const vec2& spread);
     void UpdateOneStep(float const dt);
     void UpdateAtFixedTS(float const dt);
     void ImGuiWindow();
@@ -38,7 +38,7 @@ public:
 protected:
 private:
     std::unique_ptr<bee::SimpleMeshRender> cube;
-    // pool
+    // pool, the live particles are always packed at [0, m_activeParticles)
     std::vector<Particle> m_particlePool;
     int m_poolSize = 40000;
 
@@ -49,6 +49,13 @@ private:
     int m_activeParticles = 0;
     int m_maxParticles = m_poolSize;
 
+    bee::RandomStream m_random = bee::RandomStream(0x9e3779b97f4a7c15ull, 2);
+    std::vector<float> m_spreadBuffer;
+
+    // smoothed cost of the last frames, shown in the ImGui window
+    float m_updateMilliseconds = 0.f;
+    float m_renderMilliseconds = 0.f;
+
     struct EmitterProperties
     {
         bool fixedTimeStep = false;
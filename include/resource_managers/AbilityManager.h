@@ -1,26 +1,81 @@
 ﻿#pragma once
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include "blockB/AbilityPlan.h"
 #include "blockB/AbilitySettings.h"
 
 namespace bee
 {
 
+/**
+ * \brief Owns the settings of all abilities in one dense table indexed by AbilityID.
+ * A name is interned once and keeps its ID for as long as the manager lives, even if the ability is removed and added
+ * again, so components only store the ID and the cast path never hashes a string.
+ */
 class AbilityManager
 {
 public:
-    void Add(const std::string& name, const AbilitySettings& abilitySettings);
-    [[nodiscard]] std::optional<AbilitySettings> Get(const std::string& name);
+    /**
+     * \brief Adds an ability or overrides the settings of an existing one.
+     * \return The ID of the ability.
+     */
+    AbilityID Add(const std::string& name, const AbilitySettings& abilitySettings);
+
+    /**
+     * \brief Gets the ID of a name, giving it a new one if it has never been seen.
+     * The ID does not have settings until the ability is added.
+     */
+    AbilityID Intern(const std::string& name);
+
+    /**
+     * \return The ID of the ability if an ability with this name exists, nullopt if it does not.
+     */
+    [[nodiscard]] std::optional<AbilityID> Find(const std::string& name) const;
+
+    /**
+     * \return If the ID has settings. IDs of removed abilities stay interned but do not.
+     */
+    [[nodiscard]] bool Has(AbilityID id) const;
+
+    /**
+     * \brief Gets the settings of an ability. The reference stays valid until the next Add() or Intern().
+     */
+    [[nodiscard]] const AbilitySettings& Get(AbilityID id) const;
+
+    /**
+     * \brief Gets the ops the ability runs, compiled from its settings when it was added.
+     * The reference stays valid until the next Add() or Intern().
+     */
+    [[nodiscard]] const AbilityPlan& GetPlan(AbilityID id) const;
+
+    [[nodiscard]] const std::string& GetName(AbilityID id) const;
+
     void Remove(const std::string& name);
 
+    /**
+     * \brief Calls function(id, name, settings) for every ability that exists, in the order they were interned.
+     */
+    template <typename Function>
+    void ForEach(Function&& function) const
+    {
+        for (AbilityID id = 0; id < static_cast<AbilityID>(m_names.size()); id++)
+        {
+            if (m_exists[id])
+                function(id, m_names[id], m_settings[id]);
+        }
+    }
+
 private:
-    friend class Serializer;
-    friend class ResourceManager;
-    friend class AbilityCreationMenu;
-    friend class PlayerStatsWindows;
-    std::unordered_map<std::string, AbilitySettings> m_abilities;
+    std::unordered_map<std::string, AbilityID> m_ids;
 
+    // indexed by AbilityID
+    std::vector<std::string> m_names;
+    std::vector<AbilitySettings> m_settings;
+    std::vector<AbilityPlan> m_plans;
+    std::vector<bool> m_exists;
 };
 
 }
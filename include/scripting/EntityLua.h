@@ -1,9 +1,12 @@
 #pragma once
 #include <entt/entity/entity.hpp>
+#include <entt/entity/fwd.hpp>
 #include <sol/sol.hpp>
 
 namespace bee
 {
+class StagedComponents;
+
 class EntityLua
 {
 public:
@@ -16,8 +19,22 @@ private:
 
 namespace entity_lua
 {
-void bind_entity_class(sol::state& lua);
+/**
+ * \brief The component getters look the entity up in the registry of the world the script runs in.
+ */
+void bind_entity_class(sol::state& lua, entt::registry& registry);
+
+/**
+ * \brief For the states that run scripts in parallel, the component getters return the copies in staged instead, the
+ * registry is only read.
+ */
+void bind_entity_class(sol::state& lua, const entt::registry& registry, StagedComponents& staged);
+
+void inline bind(sol::state& lua, entt::registry& registry) { bind_entity_class(lua, registry); }
 
-void inline bind(sol::state& lua) { bind_entity_class(lua); }
+void inline bind(sol::state& lua, const entt::registry& registry, StagedComponents& staged)
+{
+    bind_entity_class(lua, registry, staged);
+}
 }
 }
@@ -0,0 +1,92 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bee
+{
+
+/**
+ * \brief The allocator of a Lua state. Blocks of up to MAX_POOLED_SIZE bytes come from pools, one per size class,
+ * which carve them out of pages and keep freed blocks in a free list, so the strings, tables and closures scripts make
+ * every frame reuse the same memory instead of going through malloc. Bigger blocks go to malloc. The pages are only
+ * released when the allocator is destroyed, which must happen after the state is closed.
+ */
+class LuaAllocator
+{
+public:
+    static constexpr size_t MAX_POOLED_SIZE = 512;
+    static constexpr size_t SIZE_CLASS_COUNT = 12;
+
+    // the size of the blocks of every size class, all multiples of 16 so every block is aligned like malloc's
+    static constexpr std::array<size_t, SIZE_CLASS_COUNT> SIZE_CLASSES = {16,  32,  48,  64,  80,  96,
+                                                                          128, 160, 192, 256, 384, 512};
+
+    struct Stats
+    {
+        // what the state asked for, rounded up to the size classes
+        size_t bytesInUse = 0;
+        size_t peakBytesInUse = 0;
+
+        // the pages of the pools and the blocks from malloc, the memory taken from the system
+        size_t reservedBytes = 0;
+
+        // since the state was opened, also what was freed again
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+
+        size_t largeBlocks = 0;
+        std::array<size_t, SIZE_CLASS_COUNT> blocksInUse = {};
+
+        Stats& operator+=(const Stats& other);
+    };
+
+    LuaAllocator() = default;
+    ~LuaAllocator();
+
+    LuaAllocator(const LuaAllocator&) = delete;
+    LuaAllocator& operator=(const LuaAllocator&) = delete;
+
+    /**
+     * \brief The lua_Alloc to give to the state, with the allocator as its user data.
+     */
+    static void* Allocate(void* userData, void* block, size_t oldSize, size_t newSize);
+
+    [[nodiscard]] const Stats& GetStats() const { return m_stats; }
+
+private:
+    static constexpr size_t PAGE_SIZE = 64 * 1024;
+    static constexpr size_t NOT_POOLED = SIZE_CLASS_COUNT;
+
+    struct FreeListNode
+    {
+        FreeListNode* next;
+    };
+
+    struct Pool
+    {
+        FreeListNode* freeBlocks = nullptr;
+
+        // what is left of the last page, blocks are cut from it once the free list is empty
+        std::byte* pageCursor = nullptr;
+        std::byte* pageEnd = nullptr;
+    };
+
+    /**
+     * \return The size class of a block of the given size, NOT_POOLED for blocks that go to malloc.
+     */
+    static size_t SizeClassOf(size_t size);
+
+    void* AllocateBlock(size_t size);
+    void FreeBlock(void* block, size_t size);
+    void* ReallocateBlock(void* block, size_t oldSize, size_t newSize);
+
+    void* AllocatePooled(size_t sizeClass);
+
+    std::array<Pool, SIZE_CLASS_COUNT> m_pools = {};
+    std::vector<std::byte*> m_pages;
+    Stats m_stats;
+};
+
+} // namespace bee
@@ -0,0 +1,118 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ecs/components/ScriptComponent.h"
+#include "scripting/LuaAllocator.h"
+#include "sol/sol.hpp"
+
+namespace bee
+{
+
+/**
+ * \brief Finds out which scripts and which Lua functions are expensive. While enabled, it times every call into a
+ * script, counts the bytes the script allocates, and samples the Lua stack every thousand instructions through a count
+ * hook. The samples give the self and total time of every function. While disabled, the hook and the counting
+ * allocator are not installed and a Scope only checks a flag.
+ */
+class LuaProfiler
+{
+public:
+    explicit LuaProfiler(lua_State* lua);
+    ~LuaProfiler();
+
+    LuaProfiler(const LuaProfiler&) = delete;
+    LuaProfiler& operator=(const LuaProfiler&) = delete;
+
+    /**
+     * \brief Times one call into a script and counts what it allocates, does nothing while the profiler is disabled.
+     */
+    class Scope
+    {
+    public:
+        Scope(LuaProfiler& profiler, ScriptID script, const std::string& path);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        LuaProfiler* m_profiler = nullptr;
+        ScriptID m_script = 0;
+        const std::string* m_path = nullptr;
+        std::chrono::steady_clock::time_point m_start;
+        uint64_t m_allocatedBytes = 0;
+    };
+
+    [[nodiscard]] bool IsEnabled() const { return m_enabled; }
+    void SetEnabled(bool enabled);
+
+    /**
+     * \brief Forgets everything measured so far.
+     */
+    void Reset();
+
+    /**
+     * \brief Counts a frame, the times are shown per frame.
+     */
+    void EndFrame() { m_frames += m_enabled ? 1 : 0; }
+
+    /**
+     * \brief Writes the sampled stacks in the folded format of flame graph tools, one "root;caller;function count"
+     * line per stack.
+     */
+    [[nodiscard]] std::string ExportFoldedStacks() const;
+
+    /**
+     * \param memory Shown next to the measurements, also while the profiler is disabled.
+     * \param collectionSeconds How long the garbage collector ran in the last update.
+     */
+    void ImGuiWindow(const LuaAllocator::Stats& memory, float collectionSeconds);
+
+private:
+    struct ScriptStats
+    {
+        std::string path;
+        uint64_t calls = 0;
+        double seconds = 0.0;
+        uint64_t allocatedBytes = 0;
+    };
+
+    struct FunctionStats
+    {
+        uint64_t selfSamples = 0;
+        uint64_t totalSamples = 0;
+    };
+
+    static void Hook(lua_State* lua, lua_Debug* debug);
+    static void* CountingAllocator(void* userData, void* block, size_t oldSize, size_t newSize);
+
+    void Sample(lua_State* lua);
+
+    // instructions between two samples
+    static constexpr int SAMPLE_INTERVAL = 1000;
+    static constexpr int MAX_SAMPLED_DEPTH = 64;
+
+    lua_State* m_lua;
+    bool m_enabled = false;
+    uint64_t m_frames = 0;
+
+    // the allocator the counting allocator forwards to
+    lua_Alloc m_allocator = nullptr;
+    void* m_allocatorUserData = nullptr;
+    uint64_t m_allocatedBytes = 0;
+
+    // indexed by ScriptID
+    std::vector<ScriptStats> m_scripts;
+
+    uint64_t m_samples = 0;
+    std::unordered_map<std::string, uint64_t> m_stacks;
+    std::unordered_map<std::string, FunctionStats> m_functions;
+
+    // reused by every sample
+    std::vector<std::string> m_sampledFrames;
+};
+
+} // namespace bee
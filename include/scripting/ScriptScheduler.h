@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <entt/entity/entity.hpp>
+#include <entt/entity/fwd.hpp>
+#include <vector>
+#include "sol/sol.hpp"
+#include "tools/TimingWheel.h"
+
+namespace bee
+{
+
+/**
+ * \brief Runs Lua coroutines for scripts. A script starts one with start(entity, function, ...), and inside of it can
+ * call wait(seconds), wait_frames(frames) and wait_until(predicate). A coroutine that waits for time or frames sits
+ * in a timing wheel and costs nothing until it is due; only the predicates of wait_until are called every frame.
+ * The coroutines of an entity stop once it loses its scripts.
+ */
+class ScriptScheduler
+{
+public:
+    /**
+     * \brief Binds start and the wait functions to the Lua state.
+     */
+    ScriptScheduler(sol::state& lua, entt::registry& registry);
+
+    ScriptScheduler(const ScriptScheduler&) = delete;
+    ScriptScheduler& operator=(const ScriptScheduler&) = delete;
+
+    /**
+     * \brief Resumes every coroutine that is due.
+     * \param dt delta time
+     */
+    void Update(float dt);
+
+    /**
+     * \return The number of coroutines that have not finished.
+     */
+    [[nodiscard]] size_t Size() const { return m_coroutines.size() - m_freeCoroutines.size(); }
+
+private:
+    // what a coroutine yields to the scheduler, matches the wait functions in the .cpp
+    enum class Wait : int
+    {
+        Frames = 0, // also when a coroutine yields nothing, it then resumes the next frame
+        Seconds = 1,
+        Until = 2
+    };
+
+    struct Handle
+    {
+        uint32_t index = 0;
+        uint32_t generation = 0;
+    };
+
+    struct Coroutine
+    {
+        // kept when the coroutine finishes, the next coroutine in the slot runs on the same thread
+        sol::thread thread;
+        sol::coroutine function;
+        entt::entity entity = entt::null;
+        uint32_t generation = 0;
+    };
+
+    struct WaitUntil
+    {
+        Handle handle;
+        sol::protected_function predicate;
+    };
+
+    void Start(entt::entity entity, const sol::protected_function& function, const sol::variadic_args& args);
+
+    /**
+     * \brief Runs a coroutine up to its next wait and puts it where the wait says, or frees it when it is done.
+     */
+    template <typename... Args>
+    void Resume(Handle handle, Args&&... args);
+
+    [[nodiscard]] Coroutine* Find(Handle handle);
+    void Free(Handle handle, bool reuseThread);
+
+    sol::state& m_lua;
+    entt::registry& m_registry;
+
+    double m_time = 0.0;
+    uint64_t m_frame = 0;
+
+    // indexed by Handle::index
+    std::vector<Coroutine> m_coroutines;
+    std::vector<uint32_t> m_freeCoroutines;
+
+    TimingWheel<Handle> m_waitingSeconds;
+    TimingWheel<Handle> m_waitingFrames = TimingWheel<Handle>(1.0);
+    std::vector<WaitUntil> m_waitingUntil;
+
+    // reused every frame to poll m_waitingUntil
+    std::vector<WaitUntil> m_polling;
+};
+
+} // namespace bee
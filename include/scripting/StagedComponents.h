@@ -0,0 +1,110 @@
+#pragma once
+#include <tuple>
+#include <entt/entity/registry.hpp>
+#include <entt/entity/storage.hpp>
+#include "ecs/components/CameraComponent.h"
+#include "ecs/components/PhysicsBody2DComponent.h"
+#include "ecs/components/TransformComponent.h"
+
+namespace bee
+{
+
+/**
+ * \brief Copies of the components that the scripts of one worker state read and write while the workers run in
+ * parallel. A component is copied from the registry the first time a script asks for it and the scripts only ever see
+ * the copy, so the workers never write to the registry. The copies are written back at the sync point, when no worker
+ * runs.
+ *
+ * Scripts keep the objects they get, usually from init, so a copy stays in the same place for as long as its entity
+ * has the component. Refresh brings the copies up to date with the registry before the scripts run again.
+ */
+class StagedComponents
+{
+public:
+    /**
+     * \brief Gets the copy of a component of an entity, copying it from the registry the first time. Scripts only run
+     * right after Refresh, which forgets the copies of entities destroyed since, before their index is used again.
+     * \return The copy, or nullptr if the entity does not have the component.
+     */
+    template <typename Component>
+    Component* Get(const entt::registry& registry, entt::entity entity)
+    {
+        auto& storage = std::get<entt::storage<Staged<Component>>>(m_components);
+        if (storage.contains(entity))
+            return &storage.get(entity).component;
+
+        // the const registry does not create missing pools, so workers can read it at the same time
+        const auto* component = registry.try_get<Component>(entity);
+        if (component == nullptr)
+            return nullptr;
+        return &storage.emplace(entity, Staged<Component>{*component}).component;
+    }
+
+    /**
+     * \brief Copies the components of the registry over the copies, and forgets the copies of entities that lost the
+     * component. Only reads the registry, so every worker can refresh its own copies at the same time.
+     */
+    void Refresh(const entt::registry& registry)
+    {
+        std::apply([&registry](auto&... storages) { (Refresh(registry, storages), ...); }, m_components);
+    }
+
+    /**
+     * \brief Writes the copies back to the registry.
+     * \param owns Whether the copy of an entity should be written back. Copies of entities that other workers own
+     * were only read, writing them would undo what their owner did.
+     */
+    template <typename Owns>
+    void Apply(entt::registry& registry, const Owns& owns)
+    {
+        std::apply([&registry, &owns](auto&... storages) { (Apply(registry, owns, storages), ...); }, m_components);
+    }
+
+private:
+    /**
+     * \brief Deleted in place, so removing one copy never moves another one that a script still points to.
+     */
+    template <typename Component>
+    struct Staged
+    {
+        static constexpr bool in_place_delete = true;
+        Component component;
+    };
+
+    template <typename Component>
+    static void Refresh(const entt::registry& registry, entt::storage<Staged<Component>>& storage)
+    {
+        // erasing in place leaves the packed array as it is, so the loop can go on over it
+        for (const entt::entity entity : static_cast<const entt::sparse_set&>(storage))
+        {
+            if (entity == entt::tombstone)
+                continue;
+
+            if (const auto* component = registry.try_get<Component>(entity); component != nullptr)
+                storage.get(entity).component = *component;
+            else
+                storage.erase(entity);
+        }
+    }
+
+    template <typename Owns, typename Component>
+    static void Apply(entt::registry& registry, const Owns& owns, entt::storage<Staged<Component>>& storage)
+    {
+        for (const entt::entity entity : static_cast<const entt::sparse_set&>(storage))
+        {
+            if (entity == entt::tombstone || !owns(entity))
+                continue;
+
+            if (auto* component = registry.try_get<Component>(entity); component != nullptr)
+                *component = storage.get(entity).component;
+        }
+    }
+
+    // the pages of a storage do not move when it grows, the userdata of the scripts point into them
+    std::tuple<
+        entt::storage<Staged<TransformComponent>>, entt::storage<Staged<CameraComponent>>,
+        entt::storage<Staged<PhysicsBody2DComponent>>>
+        m_components;
+};
+
+} // namespace bee
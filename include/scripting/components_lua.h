@@ -1,6 +1,6 @@
 #pragma once
-#include "core/engine.hpp"
-#include "ecs/ECS.h"
+#include <string>
+#include <entt/entity/registry.hpp>
 
 namespace bee {
 class EntityLua;
@@ -15,11 +15,20 @@ namespace bee::components_lua
 {
 void bind_transform(sol::state& lua);
 void bind_camera(sol::state& lua);
+void bind_physics_body_2d(sol::state& lua);
+
+/**
+ * \brief Binds view(...), which goes over every entity with all the given components, for example
+ * for entity, transform, body in view(TransformComponent, PhysicsBody2DComponent) do ... end. It walks the storages of
+ * the registry directly, the entity and the components it gives are the same objects every time and only point to the
+ * next entity, so a loop does not allocate. Must be bound after the components.
+ */
+void bind_view(sol::state& lua, entt::registry& registry);
 
 template<typename T>
-T* get_component(const entt::entity& entity)
+T* get_component(entt::registry& registry, const entt::entity& entity)
 {
-    return Engine.ECS().Registry().get<T>(entity);
+    return registry.try_get<T>(entity);
 }
 
 template<typename T>
@@ -33,5 +42,6 @@ void inline bind(sol::state& lua)
 {
     bind_transform(lua);
     bind_camera(lua);
+    bind_physics_body_2d(lua);
 }
 } //namespace bee::components_lua
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <sol/sol.hpp>
+
+#include "scripting/glm_lua.h"
+
+// Shared by the glm bindings for the operations that change a value instead of returning a new one.
+
+namespace bee::glm_lua
+{
+/**
+ * \brief Binds a function as a plain C function. Sol pushes lambdas and function pointers as a new closure every time
+ * a script looks the method up, a plain C function is pushed without allocating. More than one function makes an
+ * overload.
+ */
+template <auto... Functions>
+int c_call(lua_State* lua)
+{
+    return sol::c_call<sol::wrap<decltype(Functions), Functions>...>(lua);
+}
+
+namespace inplace
+{
+template <typename T>
+void Assign(T& value, const T& other) { value = other; }
+
+template <typename T>
+void AddAssign(T& value, const T& other) { value += other; }
+
+template <typename T>
+void SubAssign(T& value, const T& other) { value -= other; }
+
+template <typename T>
+void MulAssign(T& value, const T& other) { value *= other; }
+
+template <typename T>
+void AddScaled(T& value, const T& other, const float scalar) { value += other * scalar; }
+
+template <typename T>
+void Scale(T& value, const float scalar) { value *= scalar; }
+
+template <typename T>
+void Normalize(T& value) { value = glm::normalize(value); }
+} // namespace inplace
+
+/**
+ * \brief Gives a type an array of values that scripts can use as temporaries, for example vec3.scratch[1]. A value is
+ * valid until the next script uses the same one.
+ */
+template <typename T>
+void bind_scratch(sol::state& lua, sol::usertype<T>& table, const T& value)
+{
+    sol::table scratch = lua.create_table(SCRATCH_COUNT);
+    for (int i = 1; i <= SCRATCH_COUNT; i++)
+        scratch[i] = value;
+    table["scratch"] = scratch;
+}
+} // namespace bee::glm_lua
@@ -6,6 +6,9 @@ class state;
 
 namespace bee::glm_lua
 {
+// how many values every type keeps in its scratch array
+constexpr int SCRATCH_COUNT = 8;
+
 // thanks to Luca!
 void bind_vec2(sol::state& lua);
 void bind_vec3(sol::state& lua);
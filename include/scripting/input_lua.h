@@ -5,7 +5,15 @@ namespace sol
 class state;
 }
 
+namespace bee
+{
+class Input;
+}
+
 namespace bee::input_lua
 {
-void bind(sol::state& lua);
+/**
+ * \param input The devices of the world, without them every key and button reads as up.
+ */
+void bind(sol::state& lua, const Input* input);
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "blockB/AbilitySettings.h"
+
+namespace bee
+{
+class AbilityManager;
+
+struct CombatSimulationSettings
+{
+    int matches = 1000;
+    uint64_t seed = 1;
+    unsigned threads = 0; // 0 uses all hardware threads
+    float timeStep = 1.f / 60.f;
+    float maxMatchTime = 60.f; // matches that last longer are draws
+    float spawnDistance = 20.f;
+};
+
+/**
+ * \brief Runs seeded 1v1 bot matches without a window and reports how every ability performs.
+ * Every match is a headless world of its own, and matches run in parallel on a pool of threads.
+ * The same seed and number of matches give the same report for any number of threads.
+ */
+class CombatSimulator
+{
+public:
+    explicit CombatSimulator(const AbilityManager& abilityManager);
+
+    /**
+     * \brief Runs the matches and prints the win rate, time to kill and damage per ability to stdout.
+     */
+    void Run(const CombatSimulationSettings& settings);
+
+private:
+    struct MatchResult
+    {
+        AbilityID abilities[2] = {0, 0};
+        int winner = -1; // index of the winning bot, -1 for a draw
+        float duration = 0.f;
+        float damageDealt[2] = {0.f, 0.f};
+    };
+
+    /**
+     * \brief Plays one match. Only reads the ability manager, so it can run on any thread.
+     */
+    [[nodiscard]] MatchResult RunMatch(
+        const CombatSimulationSettings& settings, uint64_t matchIndex, const std::vector<AbilityID>& abilities) const;
+
+    void PrintReport(const std::vector<MatchResult>& results, double wallTime, float simulatedTime) const;
+
+    const AbilityManager& m_abilityManager;
+};
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace bee
+{
+
+template <typename T>
+struct CurveKey
+{
+    float time = 0.f;
+    T value = {};
+};
+
+/**
+ * \brief Piecewise linear curve over [0, 1]. Keys are expected to be sorted by time, see SortKeys().
+ * Evaluating walks the keys, so it is meant to be baked into a BakedCurve instead of being evaluated every frame.
+ */
+template <typename T>
+struct Curve
+{
+    std::vector<CurveKey<T>> keys;
+
+    void SortKeys()
+    {
+        std::stable_sort(
+            keys.begin(), keys.end(), [](const CurveKey<T>& a, const CurveKey<T>& b) { return a.time < b.time; });
+    }
+
+    [[nodiscard]] T Evaluate(const float time) const
+    {
+        if (keys.empty())
+            return T{};
+        if (time <= keys.front().time)
+            return keys.front().value;
+        if (time >= keys.back().time)
+            return keys.back().value;
+
+        size_t next = 1;
+        while (keys[next].time < time)
+            next++;
+
+        const CurveKey<T>& a = keys[next - 1];
+        const CurveKey<T>& b = keys[next];
+        const float span = b.time - a.time;
+        const float step = span > 0.f ? (time - a.time) / span : 1.f;
+        return a.value + (b.value - a.value) * step;
+    }
+};
+
+/**
+ * \brief A curve sampled into a fixed size lookup table, so reading it is a single indexed load.
+ */
+template <typename T, size_t Size = 64>
+struct BakedCurve
+{
+    std::array<T, Size> samples = {};
+
+    void Bake(const Curve<T>& curve)
+    {
+        for (size_t i = 0; i < Size; i++)
+        {
+            samples[i] = curve.Evaluate(static_cast<float>(i) / static_cast<float>(Size - 1));
+        }
+    }
+
+    /**
+     * \param time Normalized time in [0, 1], values outside of it are clamped.
+     */
+    [[nodiscard]] const T& Sample(const float time) const
+    {
+        const float index = std::clamp(time, 0.f, 1.f) * static_cast<float>(Size - 1) + 0.5f;
+        return samples[static_cast<size_t>(index)];
+    }
+};
+
+} // namespace bee
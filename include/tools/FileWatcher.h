@@ -0,0 +1,50 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bee
+{
+
+/**
+ * \brief Finds the files of one type in a directory that were written since the last call. Uses inotify on Linux, so
+ * a call only reads the events that are queued. Elsewhere, or when inotify is not available, the modification times of
+ * the files are compared every poll interval. Subdirectories are not watched.
+ */
+class FileWatcher
+{
+public:
+    /**
+     * \param directory The directory to watch, the changed files are reported with this as their prefix.
+     * \param extension Only files with this extension are reported, for example ".lua".
+     * \param pollInterval Seconds between two scans of the directory when polling.
+     */
+    FileWatcher(std::string directory, std::string extension, float pollInterval = 0.5f);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * \brief Gets the files that were written since the last call, every file at most once.
+     * \param dt delta time
+     */
+    std::vector<std::string> Poll(float dt);
+
+private:
+    void Scan(std::vector<std::string>* changed);
+    [[nodiscard]] bool HasExtension(const std::string& fileName) const;
+
+    std::string m_directory;
+    std::string m_extension;
+
+    // inotify instance, -1 when polling
+    int m_inotify = -1;
+
+    float m_pollInterval;
+    float m_timeSinceScan = 0.f;
+    std::unordered_map<std::string, std::filesystem::file_time_type> m_writeTimes;
+};
+
+} // namespace bee
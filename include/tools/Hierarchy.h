@@ -59,4 +59,16 @@ private:
     };
 };
 
+/**
+ * \brief Adds the entity to the end of the children of the parent in constant time.
+ * Gives the entity a HierarchyComponent if it does not have one yet.
+ */
+void AttachToParent(entt::registry& registry, entt::entity entity, entt::entity parent);
+
+/**
+ * \brief Removes the entity from the children of its parent by swapping it with the last child, so the order of the
+ * children can change. Constant time for entities attached with AttachToParent, others are searched for.
+ */
+void DetachFromParent(entt::registry& registry, entt::entity entity);
+
 }  // namespace bee
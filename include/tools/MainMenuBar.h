@@ -12,6 +12,7 @@ struct WindowsToDisplay
         EmitterMenu = 1 << 1,
         ResourceManager = 1 << 2,
         Hierarchy = 1 << 3,
+        ScriptProfiler = 1 << 7,
         // ability menu
         AbilityMenu = 1 << 4,
         PlayerStats = 1 << 5,
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace bee
+{
+
+/**
+ * \brief Seedable random number stream. Single values come from a PCG32 generator, batches from four interleaved
+ * xoshiro128+ lanes seeded from it. Every stream owns its state, so systems and threads that own one never touch each
+ * other's sequence, and the same seed and stream id always give the same numbers on every platform.
+ */
+class RandomStream
+{
+public:
+    explicit RandomStream(uint64_t seed = 0x853c49e6748fea9bull, uint64_t streamId = 0);
+
+    /**
+     * \brief Restarts the stream at the sequence selected by the seed and stream id.
+     * \param seed The starting point of the sequence.
+     * \param streamId Streams with the same seed but different ids produce unrelated sequences.
+     */
+    void Seed(uint64_t seed, uint64_t streamId = 0);
+
+    /**
+     * \return The next 32 bit random value.
+     */
+    uint32_t NextUInt();
+
+    /**
+     * \return A random integer in [0, bound) without modulo bias.
+     */
+    uint32_t NextUInt(uint32_t bound);
+
+    /**
+     * \return A random float in [0, 1).
+     */
+    float NextFloat();
+
+    /**
+     * \return A random float in [min, max).
+     */
+    float Range(float min, float max);
+
+    /**
+     * \brief Fills a buffer with random floats in [min, max), four at a time. Uses SSE2 when the target has it, the
+     * scalar fallback produces exactly the same values.
+     * \param out The buffer to write to.
+     * \param count How many floats to write.
+     */
+    void FillRange(float* out, size_t count, float min, float max);
+
+private:
+    void NextBatch(float* out, float min, float scale);
+
+    uint64_t m_state = 0;
+    uint64_t m_increment = 0;
+    // xoshiro128+ state stored word-major, m_lanes[word][lane], so one word of all four lanes loads as one register
+    alignas(16) uint32_t m_lanes[4][4] = {};
+};
+
+/**
+ * \brief Stateless integer hash (lowbias32). Derives a reproducible random value from a seed, for when keeping a stream
+ * around is not an option.
+ */
+inline uint32_t HashUInt(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352du;
+    value ^= value >> 15;
+    value *= 0x846ca68bu;
+    value ^= value >> 16;
+    return value;
+}
+
+/**
+ * \return The upper 24 bits of the hash as a float in [-1, 1).
+ */
+inline float HashToSignedFloat(const uint32_t hash) { return static_cast<float>(hash >> 8) * (2.f / 16777216.f) - 1.f; }
+
+/**
+ * \brief Sets the seed the per-thread streams are derived from.
+ * Only threads that have not drawn a number yet are affected.
+ */
+void SetThreadRandomSeed(uint64_t seed);
+
+/**
+ * \brief The stream of the calling thread. Every thread gets its own stream id, in the order the threads first ask for
+ * one. Code that needs reproducible results across runs should own a seeded RandomStream instead.
+ */
+RandomStream& ThreadRandomStream();
+
+} // namespace bee
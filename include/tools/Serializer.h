@@ -3,6 +3,8 @@
 
 namespace bee
 {
+class AbilityManager;
+
 class Serializer
 {
 public:
@@ -16,6 +18,13 @@ public:
      */
     void Deserialize() const;
 
+    /**
+     * \brief Reads only the saved abilities, for tools that need the ability library without the scene.
+     * \param abilityManager The manager to add the abilities to.
+     * \return Whether or not it has found the serialization file.
+     */
+    bool DeserializeAbilities(AbilityManager& abilityManager) const;
+
     /**
      * \brief Checks to see it if finds the serialization file.
      * \return Whether or not it has found it.
@@ -0,0 +1,246 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bee
+{
+
+/**
+ * \brief Where the elements of every SmallVector that outgrew its inline storage live. A synchronized pool, so the
+ * blocks of the same size are recycled between entities instead of going back to the heap. It is never destroyed,
+ * components that are destroyed after main returns can still give their blocks back.
+ */
+std::pmr::memory_resource& SmallVectorOverflowResource();
+
+/**
+ * \brief Vector that keeps its first elements inside of itself. Lists in components are usually a handful of elements
+ * long, this way most entities do not allocate at all and the elements are read in-line with the rest of the
+ * component. Only once the list grows past the inline capacity are the elements moved to SmallVectorOverflowResource().
+ * Like std::vector, growing and erasing invalidate iterators, and so does moving the vector while it is inline.
+ * \tparam T The element type.
+ * \tparam N How many elements fit without allocating.
+ */
+template <typename T, size_t N>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector needs inline capacity, use std::vector otherwise");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    SmallVector(std::initializer_list<T> values)
+    {
+        reserve(values.size());
+        for (const T& value : values)
+            emplace_back(value);
+    }
+
+    SmallVector(const SmallVector& other)
+    {
+        reserve(other.m_size);
+        std::uninitialized_copy(other.begin(), other.end(), m_data);
+        m_size = other.m_size;
+    }
+
+    SmallVector(SmallVector&& other) noexcept { TakeFrom(other); }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other.m_size);
+            std::uninitialized_copy(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            Deallocate();
+            TakeFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        Deallocate();
+    }
+
+    [[nodiscard]] iterator begin() { return m_data; }
+    [[nodiscard]] iterator end() { return m_data + m_size; }
+    [[nodiscard]] const_iterator begin() const { return m_data; }
+    [[nodiscard]] const_iterator end() const { return m_data + m_size; }
+
+    [[nodiscard]] T* data() { return m_data; }
+    [[nodiscard]] const T* data() const { return m_data; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    /**
+     * \return True while the elements live inside of the vector.
+     */
+    [[nodiscard]] bool IsInline() const { return m_data == InlineData(); }
+
+    T& operator[](const size_t index)
+    {
+        assert(index < m_size);
+        return m_data[index];
+    }
+
+    const T& operator[](const size_t index) const
+    {
+        assert(index < m_size);
+        return m_data[index];
+    }
+
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[m_size - 1]; }
+    const T& back() const { return (*this)[m_size - 1]; }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity)
+        {
+            // the arguments can point into the vector, so they are constructed before the elements are moved
+            T value(std::forward<Args>(args)...);
+            Grow(m_capacity * 2);
+            return *new (m_data + m_size++) T(std::move(value));
+        }
+        return *new (m_data + m_size++) T(std::forward<Args>(args)...);
+    }
+
+    void pop_back()
+    {
+        assert(m_size > 0);
+        m_data[--m_size].~T();
+    }
+
+    iterator erase(const_iterator position) { return erase(position, position + 1); }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        const auto firstIndex = static_cast<size_t>(first - m_data);
+        const auto lastIndex = static_cast<size_t>(last - m_data);
+        if (firstIndex != lastIndex)
+        {
+            std::move(m_data + lastIndex, end(), m_data + firstIndex);
+            std::destroy(m_data + m_size - (lastIndex - firstIndex), end());
+            m_size -= lastIndex - firstIndex;
+        }
+        return m_data + firstIndex;
+    }
+
+    void clear()
+    {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
+    void reserve(const size_t capacity)
+    {
+        if (capacity > m_capacity)
+            Grow(capacity);
+    }
+
+    void resize(const size_t size)
+    {
+        if (size < m_size)
+        {
+            std::destroy(m_data + size, end());
+        }
+        else
+        {
+            reserve(size);
+            std::uninitialized_value_construct(end(), m_data + size);
+        }
+        m_size = size;
+    }
+
+private:
+    [[nodiscard]] T* InlineData() { return std::launder(reinterpret_cast<T*>(m_inline)); }
+    [[nodiscard]] const T* InlineData() const { return std::launder(reinterpret_cast<const T*>(m_inline)); }
+
+    void Grow(const size_t capacity)
+    {
+        T* data = static_cast<T*>(SmallVectorOverflowResource().allocate(capacity * sizeof(T), alignof(T)));
+        std::uninitialized_move(begin(), end(), data);
+        std::destroy(begin(), end());
+        Deallocate();
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    void Deallocate()
+    {
+        if (!IsInline())
+            SmallVectorOverflowResource().deallocate(m_data, m_capacity * sizeof(T), alignof(T));
+        m_data = InlineData();
+        m_capacity = N;
+    }
+
+    // expects this vector to be empty and inline
+    void TakeFrom(SmallVector& other)
+    {
+        if (other.IsInline())
+        {
+            std::uninitialized_move(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+            other.clear();
+            return;
+        }
+        // the overflow block changes owner, nothing is moved
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_data = other.InlineData();
+        other.m_size = 0;
+        other.m_capacity = N;
+    }
+
+    T* m_data = InlineData();
+    size_t m_size = 0;
+    size_t m_capacity = N;
+    alignas(T) std::byte m_inline[N * sizeof(T)];
+};
+
+template <typename T, size_t N>
+bool operator==(const SmallVector<T, N>& a, const SmallVector<T, N>& b)
+{
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template <typename T, size_t N>
+bool operator!=(const SmallVector<T, N>& a, const SmallVector<T, N>& b)
+{
+    return !(a == b);
+}
+
+} // namespace bee
@@ -0,0 +1,134 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace bee
+{
+
+/**
+ * \brief Hierarchical timing wheel. Payloads are scheduled at absolute times and handed back once the wheel is advanced
+ * past them. Far away payloads wait in coarser wheels and are moved down as their time comes closer, so scheduling is
+ * constant time and advancing only costs the elapsed ticks plus the payloads that fire, not the payloads that wait.
+ * \tparam Payload What is handed back when its time comes.
+ * \tparam Levels Number of wheels, every level is 2^SlotBits times coarser than the one below.
+ * \tparam SlotBits Log2 of the number of slots per wheel.
+ */
+template <typename Payload, int Levels = 4, int SlotBits = 6>
+class TimingWheel
+{
+public:
+    /**
+     * \param tickLength The resolution of the wheel in seconds. Payloads fire at most one tick late.
+     */
+    explicit TimingWheel(const double tickLength = 1.0 / 120.0) : m_tickLength(tickLength) {}
+
+    /**
+     * \brief Schedules a payload. Times that have already passed fire on the next Advance().
+     */
+    void Schedule(const double time, const Payload& payload)
+    {
+        const auto tick = static_cast<uint64_t>(std::max(std::ceil(time / m_tickLength), 0.0));
+        Insert({std::max(tick, m_currentTick + 1), payload});
+        m_size++;
+    }
+
+    /**
+     * \brief Moves the wheel up to the time and calls function(payload) for everything that is due, in tick order.
+     * Payloads the function schedules fire in the same call if they are due before the time.
+     */
+    template <typename Function>
+    void Advance(const double time, Function&& function)
+    {
+        const auto targetTick = static_cast<uint64_t>(std::max(std::floor(time / m_tickLength), 0.0));
+        while (m_currentTick < targetTick)
+        {
+            if (m_size == 0)
+            {
+                // nothing can be due, skip the idle ticks
+                m_currentTick = targetTick;
+                break;
+            }
+
+            m_currentTick++;
+            Cascade();
+
+            auto& slot = m_slots[0][m_currentTick & SLOT_MASK];
+            if (slot.empty())
+                continue;
+
+            // the function may schedule new payloads, so fire from a copy of the slot
+            m_firing.swap(slot);
+            m_size -= m_firing.size();
+            for (const Entry& entry : m_firing)
+            {
+                function(entry.payload);
+            }
+            m_firing.clear();
+        }
+    }
+
+    /**
+     * \return The number of payloads that have not fired yet.
+     */
+    [[nodiscard]] size_t Size() const { return m_size; }
+
+private:
+    static constexpr int SLOTS = 1 << SlotBits;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+    struct Entry
+    {
+        uint64_t tick = 0;
+        Payload payload;
+    };
+
+    [[nodiscard]] static constexpr uint64_t LevelSpan(const int level) { return uint64_t(1) << (SlotBits * level); }
+
+    void Insert(Entry&& entry)
+    {
+        const uint64_t delta = entry.tick - m_currentTick;
+        int level = 0;
+        while (level < Levels - 1 && delta >= LevelSpan(level + 1))
+            level++;
+
+        // beyond the coarsest wheel, park it in the slot that comes around last and place it again from there
+        const uint64_t slotTick = delta >= LevelSpan(Levels) ? m_currentTick + LevelSpan(Levels) - 1 : entry.tick;
+        m_slots[level][(slotTick >> (SlotBits * level)) & SLOT_MASK].push_back(std::move(entry));
+    }
+
+    void Cascade()
+    {
+        // every level whose slot changed with this tick pours its current slot into the levels below it,
+        // coarsest first so nothing lands in a slot that was already emptied
+        int level = 1;
+        while (level < Levels && (m_currentTick & (LevelSpan(level) - 1)) == 0)
+            level++;
+
+        for (int i = level - 1; i >= 1; i--)
+        {
+            auto& slot = m_slots[i][(m_currentTick >> (SlotBits * i)) & SLOT_MASK];
+            if (slot.empty())
+                continue;
+            m_cascading.swap(slot);
+            for (Entry& entry : m_cascading)
+            {
+                Insert(std::move(entry));
+            }
+            m_cascading.clear();
+        }
+    }
+
+    double m_tickLength = 1.0 / 120.0;
+    uint64_t m_currentTick = 0;
+    size_t m_size = 0;
+    std::array<std::array<std::vector<Entry>, SLOTS>, Levels> m_slots = {};
+
+    // reused between ticks to avoid allocations
+    std::vector<Entry> m_firing;
+    std::vector<Entry> m_cascading;
+};
+
+} // namespace bee
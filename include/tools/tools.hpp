@@ -58,7 +58,8 @@ bool StringEndsWith(const std::string& subject, const std::string& suffix);
 bool StringStartsWith(const std::string& subject, const std::string& prefix);
 
 /**
- * \brief Random number generation that uses rand() so it may not be thread safe.
+ * \brief Draws from the calling thread's RandomStream. Systems that need reproducible results should own a seeded
+ * RandomStream instead.
  * \return a random float value between -1 and 1.
  */
 float RandomFloatBtwnMinus1and1();
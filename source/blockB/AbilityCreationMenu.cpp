@@ -327,21 +327,21 @@ void bee::AbilityCreationMenu::DisplayEditCombo()
 {
     if (ImGui::BeginCombo("Edit", m_editSelectedItem.c_str()))
     {
-        const auto& abilities = Engine.ResourceManager().GetAbilityManager().m_abilities;
-        for (const auto& [abilityName, abilitySettings] : abilities)
-        {
-            const bool isSelected = (m_editSelectedItem == abilityName);
-
-            if (ImGui::Selectable(abilityName.c_str(), isSelected))
+        Engine.ResourceManager().GetAbilityManager().ForEach(
+            [this](AbilityID, const std::string& abilityName, const AbilitySettings& abilitySettings)
             {
-                m_editSelectedItem = abilityName;
-                SetSettingsForEdit(abilityName, abilitySettings);
-            }
+                const bool isSelected = (m_editSelectedItem == abilityName);
 
-            // Set the initial focus when opening the combo (scrolling + keyboard navigation focus)
-            if (isSelected)
-                ImGui::SetItemDefaultFocus();
-        }
+                if (ImGui::Selectable(abilityName.c_str(), isSelected))
+                {
+                    m_editSelectedItem = abilityName;
+                    SetSettingsForEdit(abilityName, abilitySettings);
+                }
+
+                // Set the initial focus when opening the combo (scrolling + keyboard navigation focus)
+                if (isSelected)
+                    ImGui::SetItemDefaultFocus();
+            });
         ImGui::EndCombo();
     }
 }
@@ -461,7 +461,7 @@ bool bee::AbilityCreationMenu::WarningsWindow()
 
 void bee::AbilityCreationMenu::DisplayConfirmOverrideWindowOrSaveOrOverrideAbility()
 {
-    if (Engine.ResourceManager().GetAbilityManager().Get(m_name).has_value() && !m_doNotShowConfirmOverrideWindowAgain)
+    if (Engine.ResourceManager().GetAbilityManager().Find(m_name).has_value() && !m_doNotShowConfirmOverrideWindowAgain)
         m_displayConfirmOverrideWindow = true;
     else
         SaveOrOverrideAbility();
@@ -469,7 +469,7 @@ void bee::AbilityCreationMenu::DisplayConfirmOverrideWindowOrSaveOrOverrideAbili
 
 void bee::AbilityCreationMenu::SaveOrOverrideAbility()
 {
-    Engine.ResourceManager().GetAbilityManager().Add(
+    const AbilityID abilityID = Engine.ResourceManager().GetAbilityManager().Add(
         m_name, AbilitySettings{
                     static_cast<Target>(m_targetsSelectedItem),
                     m_aoeRadius,
@@ -496,12 +496,13 @@ void bee::AbilityCreationMenu::SaveOrOverrideAbility()
     auto view = Engine.ECS().Registry().view<AbilitiesOnPlayerComponent>();
     for (auto [entity, abilitiesComponent] : view.each())
     {
-        if (static_cast<int>(abilitiesComponent.abilityNamesToInputsMap.size()) < abilitiesComponent.maxNumberOfAbilities)
+        if (static_cast<int>(abilitiesComponent.abilityIDsToInputsMap.size()) < abilitiesComponent.maxNumberOfAbilities)
         {
-            if (auto it = abilitiesComponent.abilityNamesToInputsMap.find(m_name);
-                it == abilitiesComponent.abilityNamesToInputsMap.end()) // if the player does not already have the ability
+            if (auto it = abilitiesComponent.abilityIDsToInputsMap.find(abilityID);
+                it == abilitiesComponent.abilityIDsToInputsMap.end()) // if the player does not already have the ability
             {
-                abilitiesComponent.abilityNamesToInputsMap[m_name] = {}; // nullopt
+                abilitiesComponent.abilityIDsToInputsMap[abilityID] = {}; // nullopt
+                abilitiesComponent.bindingsRevision++;
             }
         }
     }
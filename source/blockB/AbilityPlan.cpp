@@ -0,0 +1,78 @@
+#include "blockB/AbilityPlan.h"
+
+namespace
+{
+// if the ability leaves something to be reverted, ticked or ended later
+bool HasDuration(const bee::AbilitySettings& ability)
+{
+    switch (ability.applyType)
+    {
+        case bee::ApplyType::EffectOverTime:
+            return ability.numberOfTicks > 1; // the first tick is applied right away
+        case bee::ApplyType::BuffDebuff:
+        case bee::ApplyType::StatusEffect:
+            return true;
+        default:
+            return false;
+    }
+}
+} // namespace
+
+bee::AbilityPlan bee::CompileAbilityPlan(const AbilitySettings& ability)
+{
+    AbilityPlan plan;
+
+    if (ability.targetTeam == Target::Self)
+    {
+        // self cast abilities take effect right away and never hit anyone
+        if (ability.applyType == ApplyType::Instant && ability.instantType == InstantType::Dash)
+            plan.castOps.Push(AbilityOp::StartDash);
+        else if (ability.applyType == ApplyType::StatusEffect)
+            plan.castOps.Push(AbilityOp::ApplyStatusEffectToCaster);
+        else
+            plan.castOps.Push(AbilityOp::ApplyAmountToCaster);
+
+        if (HasDuration(ability))
+            plan.castOps.Push(AbilityOp::ScheduleDurationOnCaster);
+        return plan;
+    }
+
+    plan.hitsOtherTeams = ability.targetTeam == Target::Hostile;
+    plan.hitsOwnTeam = ability.targetTeam == Target::Friendly || ability.targetTeam == Target::SelfAndFriendly;
+    plan.hitsCaster = ability.targetTeam == Target::SelfAndFriendly;
+
+    plan.hitOps.Push(AbilityOp::ApplyAmountToHitPlayer);
+    if (ability.applyType == ApplyType::StatusEffect)
+        plan.hitOps.Push(AbilityOp::ApplyStatusEffectToHitPlayer);
+    if (HasDuration(ability))
+        plan.hitOps.Push(AbilityOp::ScheduleDurationOnHitPlayer);
+
+    switch (ability.castType)
+    {
+        case CastType::Projectile:
+        {
+            const bool multipleProjectiles = ability.numberOfProjectiles > 1;
+            if (!multipleProjectiles)
+                plan.castOps.Push(AbilityOp::SpawnProjectile);
+            else if (ability.shootType == ProjectileShootType::Cone)
+                plan.castOps.Push(AbilityOp::SpawnProjectileCone);
+            else
+                plan.castOps.Push(AbilityOp::SpawnProjectileLine);
+
+            plan.hitOps.Push(AbilityOp::StopProjectile);
+            plan.stopsAtFirstHit = true;
+            plan.updateOps.Push(AbilityOp::AdvanceProjectile);
+            if (multipleProjectiles && ability.shootType == ProjectileShootType::Line)
+                plan.updateOps.Push(AbilityOp::SpawnNextProjectileInLine);
+            break;
+        }
+        case CastType::RadiusAroundPlayer:
+        {
+            plan.castOps.Push(AbilityOp::SpawnAoe);
+            plan.updateOps.Push(AbilityOp::DisableAoeCollision);
+            break;
+        }
+    }
+
+    return plan;
+}
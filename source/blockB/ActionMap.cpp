@@ -0,0 +1,119 @@
+#include "blockB/ActionMap.h"
+
+#include <entt/entity/registry.hpp>
+
+#include "core/input.hpp"
+
+namespace
+{
+// the stick drifts a bit more to the positive side
+constexpr float STICK_DEAD_ZONE_NEGATIVE = -0.1f;
+constexpr float STICK_DEAD_ZONE_POSITIVE = 0.2f;
+
+float ApplyDeadZone(const float axis)
+{
+    return axis < STICK_DEAD_ZONE_NEGATIVE || axis > STICK_DEAD_ZONE_POSITIVE ? axis : 0.f;
+}
+} // namespace
+
+void bee::ActionMap::Update(entt::registry& registry, const Input& input)
+{
+    const auto playerView = registry.view<PlayerStatsComponent>();
+    for (auto [entity, playerStats] : playerView.each())
+    {
+        const int playerID = playerStats.id;
+        if (playerID < 0 || playerID >= MAX_PLAYERS)
+            continue;
+
+        auto& actions = registry.get_or_emplace<PlayerActionsComponent>(entity);
+        auto& bindings = m_bindings[playerID];
+        const auto* abilities = registry.try_get<AbilitiesOnPlayerComponent>(entity);
+        const uint32_t bindingsRevision = abilities != nullptr ? abilities->bindingsRevision : 0;
+        if (bindings.player != entity || bindings.bindingsRevision != bindingsRevision ||
+            bindings.layoutRevision != m_layoutRevision)
+        {
+            Compile(bindings, playerID, abilities, actions);
+            bindings.player = entity;
+            bindings.bindingsRevision = bindingsRevision;
+            bindings.layoutRevision = m_layoutRevision;
+        }
+
+        const bool gamepadAvailable = input.IsGamepadAvailable(playerID);
+        PlayerActionBits held = 0;
+        for (size_t action = 0; action < ACTION_COUNT; action++)
+        {
+            const int16_t key = bindings.keys[action];
+            const int16_t button = bindings.buttons[action];
+            const bool down =
+                key != NO_BINDING && input.GetKeyboardKey(static_cast<Input::KeyboardKey>(key)) ||
+                gamepadAvailable && button != NO_BINDING &&
+                    input.GetGamepadButton(playerID, static_cast<Input::GamepadButton>(button));
+            held |= static_cast<PlayerActionBits>(down) << action;
+        }
+        actions.pressed = held & ~actions.held;
+        actions.held = held;
+
+        actions.stick = glm::vec2(
+            ApplyDeadZone(input.GetGamepadAxis(playerID, Input::GamepadAxis::StickLeftX)),
+            ApplyDeadZone(input.GetGamepadAxis(playerID, Input::GamepadAxis::StickLeftY)));
+    }
+}
+
+void bee::ActionMap::ToggleKeyboardPlayers()
+{
+    m_player1and2Input = !m_player1and2Input;
+    m_layoutRevision++;
+}
+
+void bee::ActionMap::Compile(
+    CompiledBindings& bindings, const int playerID, const AbilitiesOnPlayerComponent* abilities,
+    PlayerActionsComponent& actions) const
+{
+    bindings.keys.fill(NO_BINDING);
+    bindings.buttons.fill(NO_BINDING);
+    const auto bind = [&bindings](const PlayerAction action, const std::optional<Input::KeyboardKey> key,
+                                  const std::optional<Input::GamepadButton> button)
+    {
+        const auto index = static_cast<size_t>(action);
+        if (key.has_value())
+            bindings.keys[index] = static_cast<int16_t>(key.value());
+        if (button.has_value())
+            bindings.buttons[index] = static_cast<int16_t>(button.value());
+    };
+
+    // the first and third player share WASD and the second and fourth the arrow keys, every player has a d-pad
+    const bool wasd = playerID == 0 && m_player1and2Input || playerID == 2 && !m_player1and2Input;
+    const bool arrows = playerID == 1 && m_player1and2Input || playerID == 3 && !m_player1and2Input;
+    using Key = Input::KeyboardKey;
+    using Button = Input::GamepadButton;
+    if (wasd)
+    {
+        bind(PlayerAction::MoveLeft, Key::A, std::nullopt);
+        bind(PlayerAction::MoveRight, Key::D, std::nullopt);
+        bind(PlayerAction::MoveUp, Key::W, std::nullopt);
+        bind(PlayerAction::MoveDown, Key::S, std::nullopt);
+    }
+    else if (arrows)
+    {
+        bind(PlayerAction::MoveLeft, Key::ArrowLeft, std::nullopt);
+        bind(PlayerAction::MoveRight, Key::ArrowRight, std::nullopt);
+        bind(PlayerAction::MoveUp, Key::ArrowUp, std::nullopt);
+        bind(PlayerAction::MoveDown, Key::ArrowDown, std::nullopt);
+    }
+    bind(PlayerAction::MoveLeft, std::nullopt, Button::DPadLeft);
+    bind(PlayerAction::MoveRight, std::nullopt, Button::DPadRight);
+    bind(PlayerAction::MoveUp, std::nullopt, Button::DPadUp);
+    bind(PlayerAction::MoveDown, std::nullopt, Button::DPadDown);
+
+    actions.abilitySlotCount = 0;
+    if (abilities == nullptr)
+        return;
+    for (const auto& [abilityID, inputBindings] : abilities->abilityIDsToInputsMap)
+    {
+        if (actions.abilitySlotCount == MAX_ABILITY_SLOTS)
+            break;
+        const int slot = actions.abilitySlotCount++;
+        actions.abilitySlots[slot] = abilityID;
+        bind(PlayerActionsComponent::AbilitySlot(slot), inputBindings.first, inputBindings.second);
+    }
+}
@@ -1,5 +1,6 @@
 #include "blockB/PlayerStatsWindows.h"
 
+#include <algorithm>
 #include <imgui.h>
 
 #include "core/engine.hpp"
@@ -35,7 +36,7 @@ void bee::PlayerStatsWindows::Display()
         if (ImGui::BeginTabBar((windowName + "Tab Bar").c_str()))
         {
             Info(playerComponent, abilities);
-            Edit(playerComponent, abilities);
+            Edit(playerComponent, abilities, Engine.ECS().Registry().try_get<StatModifiersComponent>(entity));
             if (m_abilitiesTab)
                 Abilities(playerComponent, abilities);
             ImGui::EndTabBar();
@@ -167,8 +168,16 @@ void bee::PlayerStatsWindows::Info(const PlayerStatsComponent& playerComponent,
     }
 }
 
-void bee::PlayerStatsWindows::Edit(PlayerStatsComponent& playerComponent, AbilitiesOnPlayerComponent& abilities)
+void bee::PlayerStatsWindows::Edit(
+    PlayerStatsComponent& playerComponent, AbilitiesOnPlayerComponent& abilities, StatModifiersComponent* modifiers)
 {
+    // active buffs and debuffs are applied again on top of the new base
+    const auto baseChanged = [modifiers](const Stat stat)
+    {
+        if (modifiers != nullptr)
+            modifiers->MarkDirty(stat);
+    };
+
     if (ImGui::BeginTabItem("Edit Stats"))
     {
         if (ImGui::InputFloat("Health", &playerComponent.baseHealth))
@@ -186,13 +195,15 @@ void bee::PlayerStatsWindows::Edit(PlayerStatsComponent& playerComponent, Abilit
         if (ImGui::InputFloat("Reload Speed", &playerComponent.baseReloadSpeed))
         {
             playerComponent.baseReloadSpeed = std::max(0.f, playerComponent.baseReloadSpeed);
-            playerComponent.currentReloadSpeed = playerComponent.baseReloadSpeed;   
+            playerComponent.currentReloadSpeed = playerComponent.baseReloadSpeed;
+            baseChanged(Stat::ReloadSpeed);
         }
 
         if (ImGui::InputFloat("Movement Speed", &playerComponent.baseMovementSpeed))
         {
             playerComponent.baseMovementSpeed = std::max(0.f, playerComponent.baseMovementSpeed);
             playerComponent.currentMovementSpeed = playerComponent.baseMovementSpeed;
+            baseChanged(Stat::MovementSpeed);
         }
 
         float baseDealtDamageModifierPercentage = playerComponent.baseDealtDamageModifier * 100.f;
@@ -201,6 +212,7 @@ void bee::PlayerStatsWindows::Edit(PlayerStatsComponent& playerComponent, Abilit
             baseDealtDamageModifierPercentage = std::max(0.f, baseDealtDamageModifierPercentage);
             playerComponent.baseDealtDamageModifier = baseDealtDamageModifierPercentage / 100.f;
             playerComponent.currentDealtDamageModifier = playerComponent.baseDealtDamageModifier;
+            baseChanged(Stat::DealtDamageModifier);
         }
 
         float baseReceivedDamageReductionPercentage = (playerComponent.baseReceivedDamageReduction - 1.f) * 100.f;
@@ -209,16 +221,18 @@ void bee::PlayerStatsWindows::Edit(PlayerStatsComponent& playerComponent, Abilit
             baseReceivedDamageReductionPercentage = std::max(0.f, baseReceivedDamageReductionPercentage);
             playerComponent.baseReceivedDamageReduction = baseReceivedDamageReductionPercentage / 100.f + 1.f;
             playerComponent.currentReceivedDamageReduction = playerComponent.baseReceivedDamageReduction;
+            baseChanged(Stat::ReceivedDamageReduction);
         }
 
         if (ImGui::InputInt("Max Number of Abilities", &abilities.maxNumberOfAbilities))
         {
-            abilities.maxNumberOfAbilities = std::max(1, abilities.maxNumberOfAbilities);
-            if (static_cast<int>(abilities.abilityNamesToInputsMap.size()) > abilities.maxNumberOfAbilities)
+            abilities.maxNumberOfAbilities = std::clamp(abilities.maxNumberOfAbilities, 1, MAX_ABILITY_SLOTS);
+            if (static_cast<int>(abilities.abilityIDsToInputsMap.size()) > abilities.maxNumberOfAbilities)
             {
-                auto deleteStart = abilities.abilityNamesToInputsMap.begin();
+                auto deleteStart = abilities.abilityIDsToInputsMap.begin();
                 std::advance(deleteStart, abilities.maxNumberOfAbilities);
-                abilities.abilityNamesToInputsMap.erase(deleteStart, abilities.abilityNamesToInputsMap.end());
+                abilities.abilityIDsToInputsMap.erase(deleteStart, abilities.abilityIDsToInputsMap.end());
+                abilities.bindingsRevision++;
             }
         }
         ImGui::EndTabItem();
@@ -248,69 +262,63 @@ void bee::PlayerStatsWindows::Abilities(
 void bee::PlayerStatsWindows::AbilitiesContent(
     const PlayerStatsComponent& playerComponent, AbilitiesOnPlayerComponent& abilities)
 {
-    const auto& abilitiesResourceManager = Engine.ResourceManager().GetAbilityManager().m_abilities;
-    const auto count = static_cast<int>(abilities.abilityNamesToInputsMap.size());
+    const auto& abilityManager = Engine.ResourceManager().GetAbilityManager();
+    const auto count = static_cast<int>(abilities.abilityIDsToInputsMap.size());
     ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 3);
     ImGui::Text("Count: %d/%d", count, abilities.maxNumberOfAbilities);
     ImGui::SameLine();
     if (ImGui::Button("+", {16.f, 16.f}))
     {
-        if (count<abilities.maxNumberOfAbilities&& static_cast<int>(abilitiesResourceManager.size())> count)
+        if (count < abilities.maxNumberOfAbilities)
         {
+            // add the first ability the player does not have yet
             bool foundNewAbility = false;
-            for (const auto& [abilityNameResourceManager, abilitySettings] : abilitiesResourceManager)
-            {
-                for (auto& [abilityNamePlayer, input] : abilities.abilityNamesToInputsMap)
+            abilityManager.ForEach(
+                [&abilities, &foundNewAbility](const AbilityID abilityID, const std::string&, const AbilitySettings&)
                 {
-                    if (abilityNamePlayer == abilityNameResourceManager)
-                    {
-                        foundNewAbility = false;
-                        break;
-                    }
-                    else
+                    if (!foundNewAbility && abilities.abilityIDsToInputsMap.count(abilityID) == 0)
                     {
+                        abilities.abilityIDsToInputsMap[abilityID] = {}; // nullopt
+                        abilities.bindingsRevision++;
                         foundNewAbility = true;
                     }
-                }
-                if (foundNewAbility || abilities.abilityNamesToInputsMap.empty())
-                {
-                    abilities.abilityNamesToInputsMap[abilityNameResourceManager] = {}; // nullopt
-                    break;
-                }
-            }
+                });
         }
     }
     ImGui::SameLine();
     help_marker("A new ability can be added only if there are any new abilities in the resource manager.");
-    if (!abilities.abilityNamesToInputsMap.empty())
+    if (!abilities.abilityIDsToInputsMap.empty())
     {
         int i = 0;
-        std::string newAbility, abilityToDelete;
-        for (auto& [abilityName, inputBindings] : abilities.abilityNamesToInputsMap)
+        std::optional<AbilityID> newAbility, abilityToDelete;
+        for (auto& [abilityID, inputBindings] : abilities.abilityIDsToInputsMap)
         {
             ImGui::PushID(i);
             i++;
             const int playerID = playerComponent.id;
             ImGui::Separator();
             ImGui::Text("Ability %d", i);
-            if (ImGui::BeginCombo("Ability", abilityName.c_str()))
+            if (ImGui::BeginCombo("Ability", abilityManager.GetName(abilityID).c_str()))
             {
-                for (const auto& [abilityNameResourceManager, abilitySettings] : abilitiesResourceManager)
-                {
-                    const bool isSelected = (m_editAbilitySelectedItem[playerID] == abilityNameResourceManager);
-
-                    if (ImGui::Selectable(abilityNameResourceManager.c_str(), isSelected) &&
-                        abilityName != abilityNameResourceManager)
+                abilityManager.ForEach(
+                    [&, currentAbilityID = abilityID](
+                        const AbilityID abilityIDResourceManager, const std::string& abilityNameResourceManager,
+                        const AbilitySettings&)
                     {
-                        m_editAbilitySelectedItem[playerID] = abilityNameResourceManager;
-                        newAbility = abilityNameResourceManager;
-                        abilityToDelete = abilityName;
-                    }
-
-                    // Set the initial focus when opening the combo (scrolling + keyboard navigation focus)
-                    if (isSelected)
-                        ImGui::SetItemDefaultFocus();
-                }
+                        const bool isSelected = (m_editAbilitySelectedItem[playerID] == abilityNameResourceManager);
+
+                        if (ImGui::Selectable(abilityNameResourceManager.c_str(), isSelected) &&
+                            currentAbilityID != abilityIDResourceManager)
+                        {
+                            m_editAbilitySelectedItem[playerID] = abilityNameResourceManager;
+                            newAbility = abilityIDResourceManager;
+                            abilityToDelete = currentAbilityID;
+                        }
+
+                        // Set the initial focus when opening the combo (scrolling + keyboard navigation focus)
+                        if (isSelected)
+                            ImGui::SetItemDefaultFocus();
+                    });
                 ImGui::EndCombo();
             }
             ImGui::Text("Input");
@@ -327,6 +335,7 @@ void bee::PlayerStatsWindows::AbilitiesContent(
                     {
                         m_keyboardSelectedItem[playerID] = std::make_pair(keyboardKey, string);
                         inputBindings.first = keyboardKey;
+                        abilities.bindingsRevision++;
                     }
 
                     // Set the initial focus when opening the combo (scrolling + keyboard navigation focus)
@@ -346,6 +355,7 @@ void bee::PlayerStatsWindows::AbilitiesContent(
                     {
                         m_controllerSelectedItem[playerID] = std::make_pair(controllerButton, string);
                         inputBindings.second = controllerButton;
+                        abilities.bindingsRevision++;
                     }
 
                     // Set the initial focus when opening the combo (scrolling + keyboard navigation focus)
@@ -356,10 +366,11 @@ void bee::PlayerStatsWindows::AbilitiesContent(
             }
             ImGui::PopID();
         }
-        if (!newAbility.empty())
+        if (newAbility.has_value())
         {
-            abilities.abilityNamesToInputsMap[newAbility] = abilities.abilityNamesToInputsMap[abilityToDelete];
-            abilities.abilityNamesToInputsMap.erase(abilityToDelete);
+            abilities.abilityIDsToInputsMap[newAbility.value()] = abilities.abilityIDsToInputsMap[abilityToDelete.value()];
+            abilities.abilityIDsToInputsMap.erase(abilityToDelete.value());
+            abilities.bindingsRevision++;
         }
     }
 }
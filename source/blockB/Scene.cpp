@@ -97,6 +97,14 @@ void bee::Scene::Init()
             transformPos.scale.y = body.scale;
         }
     }
+
+    // layers are not serialized
+    auto playerBodyView = m_registry.view<PlayerStatsComponent, PhysicsBody2DComponent>();
+    for (auto [player, playerStats, body] : playerBodyView.each())
+    {
+        body.layer = CollisionLayer2D::Player;
+    }
+
     m_playerStatsWindows.Init();
 }
 
@@ -104,16 +112,18 @@ void bee::Scene::InputHandling()
 {
     const auto& input = Engine.Input();
 
-    if (input.GetMouseButton(Input::MouseButton::Right))
-        return;
-
     if (input.GetKeyboardKeyOnce(Input::KeyboardKey::LeftAlt))
     {
-        m_player1and2Input = !m_player1and2Input;
+        m_actionMap.ToggleKeyboardPlayers();
     }
+    // the AbilitySystem casts from the same actions
+    m_actionMap.Update(m_registry, input);
+
+    if (input.GetMouseButton(Input::MouseButton::Right))
+        return;
 
-    auto playerView = m_registry.view<PlayerStatsComponent, PhysicsBody2DComponent>();
-    for (auto [entity, playerComponent, physicsBodyComponent] : playerView.each())
+    auto playerView = m_registry.view<PlayerStatsComponent, PlayerActionsComponent, PhysicsBody2DComponent>();
+    for (auto [entity, playerComponent, actions, physicsBodyComponent] : playerView.each())
     {
         if (playerComponent.state & PlayerStatsComponent::State::Dashing)
         {
@@ -126,81 +136,17 @@ void bee::Scene::InputHandling()
             continue;
         }
 
-        const float moveBy = playerComponent.currentMovementSpeed;
-        auto velocity = glm::vec2(0.0f);
-
-        // keyboard
-        if (playerComponent.id == 0 && m_player1and2Input || playerComponent.id == 2 && !m_player1and2Input)
-        {
-            if (input.GetKeyboardKey(Input::KeyboardKey::A))
-            {
-                velocity.x -= moveBy;
-            }
-            if (input.GetKeyboardKey(Input::KeyboardKey::D))
-            {
-                velocity.x += moveBy;
-            }
-            if (input.GetKeyboardKey(Input::KeyboardKey::W))
-            {
-                velocity.y -= moveBy;
-            }
-            if (input.GetKeyboardKey(Input::KeyboardKey::S))
-            {
-                velocity.y += moveBy;
-            }
-        }
-        else if (playerComponent.id == 1 && m_player1and2Input || playerComponent.id == 3 && !m_player1and2Input)
-        {
-            if (input.GetKeyboardKey(Input::KeyboardKey::ArrowLeft))
-            {
-                velocity.x -= moveBy;
-            }
-            if (input.GetKeyboardKey(Input::KeyboardKey::ArrowRight))
-            {
-                velocity.x += moveBy;
-            }
-            if (input.GetKeyboardKey(Input::KeyboardKey::ArrowUp))
-            {
-                velocity.y -= moveBy;
-            }
-            if (input.GetKeyboardKey(Input::KeyboardKey::ArrowDown))
-            {
-                velocity.y += moveBy;
-            }
-        }
+        // keyboard and d-pad
+        auto direction = glm::vec2(0.0f);
+        direction.x -= static_cast<float>(actions.IsHeld(PlayerAction::MoveLeft));
+        direction.x += static_cast<float>(actions.IsHeld(PlayerAction::MoveRight));
+        direction.y -= static_cast<float>(actions.IsHeld(PlayerAction::MoveUp));
+        direction.y += static_cast<float>(actions.IsHeld(PlayerAction::MoveDown));
 
         // controller stick
-        const float axisX = input.GetGamepadAxis(playerComponent.id, Input::GamepadAxis::StickLeftX);
-        const float axisY = input.GetGamepadAxis(playerComponent.id, Input::GamepadAxis::StickLeftY);
-
-        if (axisX < -0.1f || axisX > 0.2f)
-        {
-            velocity.x += playerComponent.currentMovementSpeed * axisX;
-        }
-        if (axisY < -0.1f || axisY > 0.2f)
-        {
-            velocity.y += playerComponent.currentMovementSpeed * axisY;
-        }
-
-        // controller d-pad
-        if (input.GetGamepadButton(playerComponent.id, Input::GamepadButton::DPadLeft))
-        {
-            velocity.x -= moveBy;
-        }
-        if (input.GetGamepadButton(playerComponent.id, Input::GamepadButton::DPadRight))
-        {
-            velocity.x += moveBy;
-        }
-        if (input.GetGamepadButton(playerComponent.id, Input::GamepadButton::DPadUp))
-        {
-            velocity.y -= moveBy;
-        }
-        if (input.GetGamepadButton(playerComponent.id, Input::GamepadButton::DPadDown))
-        {
-            velocity.y += moveBy;
-        }
+        direction += actions.stick;
 
-        physicsBodyComponent.velocity = velocity;
+        physicsBodyComponent.velocity = direction * playerComponent.currentMovementSpeed;
     }
 }
 
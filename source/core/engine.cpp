@@ -33,7 +33,11 @@ void EngineClass::Initialize()
     m_device = std::make_unique<bee::Device>();
     m_input = std::make_unique<bee::Input>();
     m_resourceManager = std::make_unique<bee::ResourceManager>();
-    m_ecs = std::make_unique<bee::ECS>();
+    WorldContext worldContext;
+    worldContext.abilityManager = &m_resourceManager->GetAbilityManager();
+    worldContext.resources = m_resourceManager.get();
+    worldContext.input = m_input.get();
+    m_ecs = std::make_unique<bee::ECS>(worldContext);
     m_debugRenderer = std::make_unique<bee::DebugRenderer>();
     m_simpleRenderer = std::make_unique<bee::SimpleRenderer>();
     ImGui_Impl_Init();
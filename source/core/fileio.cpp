@@ -91,13 +91,16 @@ bool FileIO::Exists(Directory type, const std::string& path)
     return good;
 }
 
-#ifdef PLATFORM_DEKSTOP
-uint64_t FileIO::LastModified(Type type, const std::string& path)
+#ifdef PLATFORM_DESKTOP
+uint64_t FileIO::LastModified(Directory type, const std::string& path)
 {
     const auto fullPath = GetPath(type, path);
-    std::filesystem::file_time_type ftime = std::filesystem::last_write_time(fullPath);
+    std::error_code error;
+    const std::filesystem::file_time_type ftime = std::filesystem::last_write_time(fullPath, error);
+    if (error)
+        return 0;
     return static_cast<uint64_t>(ftime.time_since_epoch().count());
 }
 #else
 uint64_t FileIO::LastModified(Directory type, const std::string& path) { return 0; }
-#endif // PLATFORM_DEKSTOP
+#endif // PLATFORM_DESKTOP
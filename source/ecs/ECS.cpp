@@ -3,18 +3,28 @@
 #include <glm/gtc/type_ptr.hpp>
 #include "core/engine.hpp"
 #include "ecs/components/TransformComponent.h"
+#include "resource_managers/ResourceManager.h"
 #include "rendering/simple_renderer.hpp"
 
 namespace bee
 {
-ECS::ECS()
+ECS::ECS(const WorldContext& context)
 {
-    m_systems.emplace_back(std::make_unique<ParticleSystem>(m_registry));
-    m_systems.emplace_back(std::make_unique<ScriptSystem>(m_registry));
+    // the systems read the context in their constructors
+    m_registry.ctx().emplace<WorldContext>(context);
+
+    if (!context.headless)
+    {
+        m_systems.emplace_back(std::make_unique<ParticleSystem>(m_registry));
+        m_systems.emplace_back(std::make_unique<ScriptSystem>(m_registry));
+    }
     m_systems.emplace_back(std::make_unique<AbilitySystem>(m_registry));
     m_systems.emplace_back(std::make_unique<PhysicsSystem2D>(m_registry));
 }
 
+// the systems are only complete here
+ECS::~ECS() = default;
+
 void ECS::Update(const float& dt) const
 {
     for (auto& system : m_systems)
@@ -1,10 +1,10 @@
 #include "ecs/systems/AbilitySystem.h"
 
+#include <algorithm>
 #include <imgui.h>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "core/engine.hpp"
-#include "core/input.hpp"
 #include "ecs/ECS.h"
 #include "resource_managers/ResourceManager.h"
 
@@ -12,12 +12,49 @@
 #include "ecs/components/AbilityComponent.h"
 #include "ecs/components/PhysicsBody2DComponent.h"
 #include "ecs/components/compact_includes/HierarchyIncludeComponents.h"
+#include "tools/Hierarchy.h"
 #include "tools/MainMenuBar.h"
 #include "tools/tools.hpp"
 
 constexpr float pi = 3.1415927f;
 
-bee::AbilitySystem::AbilitySystem(entt::registry& registry) : BaseSystem(registry)
+namespace
+{
+// lets hits sorted by ability be searched by the ability alone
+struct CompareHitAbility
+{
+    bool operator()(const bee::AbilityHitEvent2D& hit, const entt::entity ability) const { return hit.ability < ability; }
+    bool operator()(const entt::entity ability, const bee::AbilityHitEvent2D& hit) const { return ability < hit.ability; }
+};
+
+// the current and base value of every stat, indexed by bee::Stat
+struct StatFields
+{
+    float bee::PlayerStatsComponent::*current;
+    float bee::PlayerStatsComponent::*base;
+};
+
+constexpr StatFields STAT_FIELDS[bee::StatModifiersComponent::STAT_COUNT] = {
+    {&bee::PlayerStatsComponent::currentHealth, &bee::PlayerStatsComponent::baseHealth},
+    {&bee::PlayerStatsComponent::currentAmmo, &bee::PlayerStatsComponent::baseAmmo},
+    {&bee::PlayerStatsComponent::currentReloadSpeed, &bee::PlayerStatsComponent::baseReloadSpeed},
+    {&bee::PlayerStatsComponent::currentMovementSpeed, &bee::PlayerStatsComponent::baseMovementSpeed},
+    {&bee::PlayerStatsComponent::currentDealtDamageModifier, &bee::PlayerStatsComponent::baseDealtDamageModifier},
+    {&bee::PlayerStatsComponent::currentReceivedDamageReduction,
+     &bee::PlayerStatsComponent::baseReceivedDamageReduction},
+};
+
+const StatFields& GetStatFields(const bee::Stat stat) { return STAT_FIELDS[static_cast<size_t>(stat)]; }
+
+// pools are used up and refilled, so they are changed directly instead of through modifiers
+bool IsPoolStat(const bee::Stat stat) { return stat == bee::Stat::Health || stat == bee::Stat::Ammo; }
+} // namespace
+
+bee::AbilitySystem::AbilitySystem(entt::registry& registry)
+    : BaseSystem(registry),
+      m_context(registry.ctx().get<WorldContext>()),
+      m_abilityManager(*m_context.abilityManager),
+      m_headless(m_context.headless)
 {
     m_statColors = {
         {{Stat::Health, IncreaseOrDecrease::Increase}, {0.f, 1.f, 0.f, 1.0f}},
@@ -35,271 +72,107 @@ bee::AbilitySystem::AbilitySystem(entt::registry& registry) : BaseSystem(registr
 
 void bee::AbilitySystem::Update(const float& dt)
 {
-    UpdateAmmoAndDisplayVisualEffects(dt);
+    // modifiers changed from outside of the update, like the stat editor
+    RefreshDirtyStats();
+    UpdateAmmo(dt);
+    UpdateTimedEffects(dt);
     UpdateAbilities(dt);
     CheckInputToCreateAbilities();
-    DisplayVisualEffectsEditor();
+    // read after the update, like the movement speed in Scene::InputHandling
+    RefreshDirtyStats();
+    if (!m_headless)
+        DisplayVisualEffectsEditor();
 }
 
-void bee::AbilitySystem::UpdateAmmoAndDisplayVisualEffects(const float dt)
+void bee::AbilitySystem::UpdateAmmo(const float dt)
 {
-    auto playerView = m_registry.view<PlayerStatsComponent, MeshComponent>();
-    for (auto [entity, playerStats, mesh] : playerView.each())
+    auto playerView = m_registry.view<PlayerStatsComponent>();
+    for (auto [entity, playerStats] : playerView.each())
     {
-        // update ammo
         if (playerStats.currentAmmo < playerStats.baseAmmo)
         {
             playerStats.currentAmmo += playerStats.currentReloadSpeed * dt;
         }
-
-        // visual effects
-        for (auto visualEffectIter = playerStats.visualEffects.begin(); visualEffectIter != playerStats.visualEffects.end();)
-        {
-            mesh.mulColor = visualEffectIter->color;
-            visualEffectIter->currentDuration -= dt;
-            if (visualEffectIter->currentDuration <= 0.f)
-            {
-                mesh.mulColor = m_teamColors[playerStats.teamId];
-                visualEffectIter = playerStats.visualEffects.erase(visualEffectIter);
-            }
-            else
-            {
-                ++visualEffectIter;
-            }
-        }
     }
 }
 
+void bee::AbilitySystem::UpdateTimedEffects(const float dt)
+{
+    m_time += static_cast<double>(dt);
+    m_timedEffects.Advance(m_time, [this](const TimedEffect& timedEffect) { FireTimedEffect(timedEffect); });
+}
+
 void bee::AbilitySystem::UpdateAbilities(const float dt)
 {
+    // hits from the last physics update, grouped by ability so every ability finds its own with a binary search
+    m_abilityHits.clear();
+    if (const auto* collisionEvents = m_registry.ctx().find<CollisionEvents2D>())
+    {
+        m_abilityHits.assign(collisionEvents->abilityHits.begin(), collisionEvents->abilityHits.end());
+        std::stable_sort(
+            m_abilityHits.begin(), m_abilityHits.end(),
+            [](const AbilityHitEvent2D& a, const AbilityHitEvent2D& b) { return a.ability < b.ability; });
+    }
+
+    // only cast abilities are entities, self cast abilities and anything with a duration live in m_timedEffects
     auto abilityView = m_registry.view<AbilityComponent>();
     for (auto [ability, abilityComponent] : abilityView.each())
     {
-        auto& castByPlayerStats = m_registry.get<PlayerStatsComponent>(abilityComponent.castByPlayer);
-        auto& abilitySettings = abilityComponent.settings;
-        const bool targetSelf = abilitySettings.targetTeam == Target::Self;
-
-        // dash
-        if (targetSelf && abilitySettings.applyType == ApplyType::Instant && abilitySettings.instantType == InstantType::Dash)
-        {
-            abilityComponent.currentDurationAmount -= dt;
-            if (abilityComponent.currentDurationAmount <= 0.0f)
-            {
-                auto& playerPhysicsBody = m_registry.get<PhysicsBody2DComponent>(abilityComponent.castByPlayer);
-                playerPhysicsBody.velocity = glm::vec2(0.f);
-                castByPlayerStats.state &= ~PlayerStatsComponent::State::Dashing; // dashing off
-                m_registry.destroy(ability);
-            }
-        }
-        else
+        const auto& plan = m_abilityManager.GetPlan(abilityComponent.abilityID);
+        OpContext context;
+        context.abilityID = abilityComponent.abilityID;
+        context.ability = &m_abilityManager.Get(abilityComponent.abilityID);
+        context.castByPlayer = abilityComponent.castByPlayer;
+        context.castByPlayerStats = &m_registry.get<PlayerStatsComponent>(abilityComponent.castByPlayer);
+        context.abilityEntity = ability;
+        context.abilityComponent = &abilityComponent;
+        context.dt = dt;
+
+        // check for hit
+        const auto [hitsBegin, hitsEnd] =
+            std::equal_range(m_abilityHits.begin(), m_abilityHits.end(), ability, CompareHitAbility());
+        // a projectile stops at the first player it hits
+        for (auto hit = hitsBegin; hit != hitsEnd && m_registry.all_of<AbilityComponent>(ability) &&
+                                   (!plan.stopsAtFirstHit || !abilityComponent.dead);
+             ++hit)
         {
-            // check for hit to update and apply durational effects
-            auto* playerHit = m_registry.try_get<PlayerStatsComponent>(abilityComponent.hitPlayer);
-            if (playerHit != nullptr)
+            auto* hitPlayerStats =
+                m_registry.valid(hit->player) ? m_registry.try_get<PlayerStatsComponent>(hit->player) : nullptr;
+            if (hitPlayerStats == nullptr)
+                continue;
+
+            const bool sameTeam = context.castByPlayerStats->teamId == hitPlayerStats->teamId;
+            const bool isCaster = context.castByPlayerStats->id == hitPlayerStats->id;
+            if (sameTeam ? plan.hitsOwnTeam && (plan.hitsCaster || !isCaster) : plan.hitsOtherTeams)
             {
-                if (targetSelf || (abilitySettings.castType == CastType::Projectile && abilityComponent.dead ||
-                                   abilitySettings.castType == CastType::RadiusAroundPlayer && !abilityComponent.dead))
-                {
-                    auto& hitPlayerStats = *playerHit;
-                    abilityComponent.currentDurationAmount -= dt;
-                    if (abilityComponent.currentDurationAmount <= 0.0f)
-                    {
-                        switch (abilitySettings.applyType)
-                        {
-                            case ApplyType::Instant:
-                            {
-                                break;
-                            }
-                            case ApplyType::EffectOverTime:
-                            {
-                                abilityComponent.currentDurationAmount = abilitySettings.durationAmount;
-                                abilityComponent.currentNumberOfTicks--;
-                                ApplyAmount(abilityComponent.settings, hitPlayerStats, castByPlayerStats, false);
-
-                                if (abilityComponent.currentNumberOfTicks <= 0)
-                                {
-                                    m_registry.destroy(ability);
-                                }
-                                break;
-                            }
-                            case ApplyType::BuffDebuff:
-                            {
-                                ApplyAmount(abilityComponent.settings, hitPlayerStats, castByPlayerStats, true);
-                                m_registry.destroy(ability);
-                                break;
-                            }
-                            case ApplyType::StatusEffect:
-                            {
-                                hitPlayerStats.state &= ~(1 << static_cast<unsigned>(abilitySettings.statusEffectType));
-                                m_registry.destroy(ability);
-                                break;
-                            }
-                        }
-                    }
-                }
+                context.hitPlayer = hit->player;
+                context.hitPlayerStats = hitPlayerStats;
+                RunOps(plan.hitOps, context);
             }
         }
 
-        // cast abilities
-        if (!targetSelf)
-        {
-            // check for hit
-            const auto tryGetPhysicsBody = m_registry.try_get<PhysicsBody2DComponent>(ability);
-            bool abilityDeadCondition = abilitySettings.castType == CastType::Projectile ? !abilityComponent.dead : true;
-            if (tryGetPhysicsBody != nullptr && abilityDeadCondition)
-            {
-                auto& physicsBody = *tryGetPhysicsBody;
-                for (const auto& collision : physicsBody.collisions)
-                {
-                    auto checkIfPlayerHit = m_registry.try_get<PlayerStatsComponent>(collision.entity2);
-                    if (checkIfPlayerHit)
-                    {
-                        auto& hitPlayerStats = *checkIfPlayerHit;
-                        if (castByPlayerStats.teamId != hitPlayerStats.teamId &&
-                                abilitySettings.targetTeam == Target::Hostile ||
-                            castByPlayerStats.teamId == hitPlayerStats.teamId &&
-                                (abilitySettings.targetTeam == Target::Friendly && castByPlayerStats.id != hitPlayerStats.id ||
-                                 abilitySettings.targetTeam == Target::SelfAndFriendly))
-                        {
-                            switch (abilitySettings.castType)
-                            {
-                                case CastType::Projectile:
-                                {
-                                    ApplyAmount(abilitySettings, hitPlayerStats, castByPlayerStats, false);
-                                    switch (abilitySettings.applyType)
-                                    {
-                                        case ApplyType::Instant:
-                                        {
-                                            DestroyOrEraseComponentsBasedOnFirstProjectileInLine(ability, abilityComponent);
-                                            break;
-                                        }
-                                        case ApplyType::EffectOverTime:
-                                        case ApplyType::BuffDebuff:
-                                        case ApplyType::StatusEffect:
-                                        {
-                                            abilityComponent.hitPlayer = collision.entity2;
-                                            RemoveFromHierarchy(ability);
-                                            m_registry.erase<HierarchyComponent, MeshComponent, TransformComponent>(ability);
-                                            abilityComponent.dead = true;
-                                            if (abilitySettings.applyType == ApplyType::EffectOverTime)
-                                            {
-                                                abilityComponent.currentNumberOfTicks--;
-                                            }
-                                            if (abilitySettings.applyType == ApplyType::StatusEffect)
-                                            {
-                                                ApplyStatusEffect(abilitySettings, hitPlayerStats);
-                                            }
-                                            break;
-                                        }
-                                    }
-                                    break;
-                                }
-                                case CastType::RadiusAroundPlayer:
-                                {
-                                    ApplyAmount(abilitySettings, hitPlayerStats, castByPlayerStats, false);
-                                    switch (abilitySettings.applyType)
-                                    {
-                                        case ApplyType::Instant:
-                                        {
-                                            break;
-                                        }
-                                        case ApplyType::EffectOverTime:
-                                        case ApplyType::BuffDebuff:
-                                        case ApplyType::StatusEffect:
-                                        {
-                                            auto durationalAbility = m_registry.create();
-                                            auto& durationalAbilityComponent =
-                                                m_registry.emplace<AbilityComponent>(durationalAbility, abilityComponent);
-                                            durationalAbilityComponent.hitPlayer = collision.entity2;
-                                            durationalAbilityComponent.dead = false;
-                                            if (abilitySettings.applyType == ApplyType::EffectOverTime)
-                                            {
-                                                durationalAbilityComponent.currentNumberOfTicks--;
-                                            }
-                                            if (durationalAbilityComponent.settings.applyType == ApplyType::StatusEffect)
-                                            {
-                                                ApplyStatusEffect(durationalAbilityComponent.settings, hitPlayerStats);
-                                            }
-                                            break;
-                                        }
-                                    }
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-                if (abilitySettings.castType == CastType::RadiusAroundPlayer)
-                {
-                    // if an aoe ability has hit at least one player delete the physics body
-                    // so it cannot register more collisions
-                    m_registry.erase<PhysicsBody2DComponent>(ability);
-                }
-            }
-            // actions that need to be performed regardless if the ability has hit a player or not
-            switch (abilitySettings.castType)
-            {
-                case CastType::Projectile:
-                {
-                    // update projectile range
-                    const bool maxRangeReached = abilityComponent.currentProjectileRange >= abilitySettings.projectileRange;
-                    if (maxRangeReached && !abilityComponent.dead)
-                    {
-                        DestroyOrEraseComponentsBasedOnFirstProjectileInLine(ability, abilityComponent);
-                    }
-                    abilityComponent.currentProjectileRange += abilitySettings.projectileSpeed * dt;
-
-                    const bool firstProjectileInLine = abilitySettings.shootType == ProjectileShootType::Line &&
-                                                       abilityComponent.firstProjectileInLine == true;
-                    if (firstProjectileInLine)
-                    {
-                        ProjectilesInLineLogic(ability, abilityComponent);
-                    }
-                    break;
-                }
-                case CastType::RadiusAroundPlayer:
-                {
-                    if (abilityComponent.dead == true)
-                    {
-                        abilityComponent.currentAoeDuration -= dt;
-                        if (abilityComponent.currentAoeDuration <= 0.f)
-                        {
-                            RemoveFromHierarchy(ability);
-                            m_registry.destroy(ability);
-                        }
-                    }
-                    break;
-                }
-            }
-        }
+        // actions that need to be performed regardless if the ability has hit a player or not
+        if (m_registry.all_of<AbilityComponent>(ability)) // can be released to the pool by a hit
+            RunOps(plan.updateOps, context);
     }
 }
 
 void bee::AbilitySystem::CheckInputToCreateAbilities()
 {
-    auto abilitiesOnPlayerView = m_registry.view<AbilitiesOnPlayerComponent, PlayerStatsComponent>();
-    for (auto [entity, ability, playerStats] : abilitiesOnPlayerView.each())
+    // the actions are written before the systems update, by the ActionMap of the scene or by whoever drives the world
+    auto playerActionsView = m_registry.view<PlayerActionsComponent, PlayerStatsComponent>();
+    for (auto [entity, actions, playerStats] : playerActionsView.each())
     {
         if (playerStats.state & PlayerStatsComponent::State::Dashing ||
             playerStats.state & PlayerStatsComponent::State::Silenced ||
             playerStats.state & PlayerStatsComponent::State::Stunned)
             continue;
 
-        for (auto& [abilityName, inputBindings] : ability.abilityNamesToInputsMap)
+        for (int slot = 0; slot < actions.abilitySlotCount; slot++)
         {
-            if (inputBindings.first != std::nullopt)
+            if (actions.WasPressed(PlayerActionsComponent::AbilitySlot(slot)))
             {
-                if (Engine.Input().GetKeyboardKeyOnce(inputBindings.first.value()))
-                {
-                    CreateAbility(abilityName, entity);
-                }
-            }
-            if (inputBindings.second != std::nullopt)
-            {
-                if (Engine.Input().GetGamepadButtonOnce(playerStats.id, inputBindings.second.value()))
-                {
-                    CreateAbility(abilityName, entity);
-                }
+                CreateAbility(actions.abilitySlots[slot], entity);
             }
         }
     }
@@ -323,8 +196,11 @@ void bee::AbilitySystem::DisplayVisualEffectsEditor()
     ImGui::End();
 }
 
-void bee::AbilitySystem::CreateAbility(const std::string& abilityName, entt::entity castByPlayer)
+void bee::AbilitySystem::CreateAbility(const AbilityID abilityID, entt::entity castByPlayer)
 {
+    if (!m_abilityManager.Has(abilityID))
+        return; // the ability was deleted
+
     auto& playerStats = m_registry.get<PlayerStatsComponent>(castByPlayer);
 
     if (playerStats.currentAmmo < 1.f)
@@ -333,232 +209,368 @@ void bee::AbilitySystem::CreateAbility(const std::string& abilityName, entt::ent
     // decrease ammo
     playerStats.currentAmmo -= 1.0f;
 
-    // create ability
-    auto ability = m_registry.create();
-    auto& abilityComponent = m_registry.emplace<AbilityComponent>(
-        ability, castByPlayer,
-        Engine.ResourceManager().GetAbilityManager().Get(abilityName).value()); // NOLINT(bugprone-unchecked-optional-access)
+    OpContext context;
+    context.abilityID = abilityID;
+    context.ability = &m_abilityManager.Get(abilityID);
+    context.castByPlayer = castByPlayer;
+    context.castByPlayerStats = &playerStats;
+    RunOps(m_abilityManager.GetPlan(abilityID).castOps, context);
+}
+
+void bee::AbilitySystem::RunOps(const AbilityOpList& ops, OpContext& context)
+{
+    for (const AbilityOp op : ops)
+    {
+        (this->*m_opTable[static_cast<size_t>(op)])(context);
+        // the ability entity was released to the pool, the ops after this one have nothing to work on
+        if (context.abilityComponent != nullptr && !m_registry.all_of<AbilityComponent>(context.abilityEntity))
+            return;
+    }
+}
+
+void bee::AbilitySystem::ApplyAmountToCasterOp(OpContext& context)
+{
+    context.applied =
+        ApplyAmount(*context.ability, context.castByPlayer, *context.castByPlayerStats, *context.castByPlayerStats);
+}
 
-    auto& abilitySettings = abilityComponent.settings;
+void bee::AbilitySystem::ApplyStatusEffectToCasterOp(OpContext& context)
+{
+    ApplyStatusEffect(*context.ability, context.castByPlayer, *context.castByPlayerStats);
+}
 
-    if (abilitySettings.targetTeam == Target::Self)
+void bee::AbilitySystem::StartDashOp(OpContext& context)
+{
+    auto& playerPhysicsBody = m_registry.get<PhysicsBody2DComponent>(context.castByPlayer);
+    const auto& playerTransform = m_registry.get<TransformComponent>(context.castByPlayer);
+    const glm::vec2 direction2D = GetXZDirectionFromQuaternion(playerTransform.rotation);
+    playerPhysicsBody.velocity = direction2D * context.ability->dashSpeed;
+    context.castByPlayerStats->state = PlayerStatsComponent::State::Dashing;
+
+    TimedEffect dashEnd;
+    dashEnd.type = TimedEffect::Type::DashEnd;
+    dashEnd.time = m_time + context.ability->durationAmount;
+    dashEnd.target = context.castByPlayer;
+    m_timedEffects.Schedule(dashEnd.time, dashEnd);
+}
+
+void bee::AbilitySystem::ScheduleDurationOnCasterOp(OpContext& context)
+{
+    ScheduleDurationalEffect(
+        context.abilityID, *context.ability, context.castByPlayer, context.castByPlayer, context.applied);
+}
+
+void bee::AbilitySystem::PrepareProjectile(
+    const OpContext& context, MeshComponent& meshComponent, PhysicsBody2DComponent& physicsBody,
+    TransformComponent& transformComponent)
+{
+    const auto& abilitySettings = *context.ability;
+    if (!m_headless)
     {
-        switch (abilitySettings.applyType)
-        {
-            case ApplyType::Instant:
-            {
-                switch (abilitySettings.instantType)
-                {
-                    case InstantType::Effect:
-                    {
-                        ApplyAmount(abilitySettings, playerStats, playerStats, false);
-                        m_registry.destroy(ability);
-                        break;
-                    }
-                    case InstantType::Dash:
-                    {
-                        auto& playerPhysicsBody = m_registry.get<PhysicsBody2DComponent>(abilityComponent.castByPlayer);
-                        const auto& playerTransform = m_registry.get<TransformComponent>(abilityComponent.castByPlayer);
-                        const glm::vec2 direction2D = GetXZDirectionFromQuaternion(playerTransform.rotation);
-                        playerPhysicsBody.velocity = direction2D * abilitySettings.dashSpeed;
-                        playerStats.state = PlayerStatsComponent::State::Dashing;
-                        break;
-                    }
-                }
-                break;
-            }
-            case ApplyType::EffectOverTime:
-            case ApplyType::BuffDebuff:
-            {
-                ApplyAmount(abilitySettings, playerStats, playerStats, false);
-                if (abilitySettings.applyType == ApplyType::EffectOverTime)
-                {
-                    abilityComponent.currentNumberOfTicks--;
-                }
-                break;
-            }
-            case ApplyType::StatusEffect:
-            {
-                ApplyStatusEffect(abilitySettings, playerStats);
-                break;
-            }
-        }
-        abilityComponent.hitPlayer = castByPlayer;
+        meshComponent.mesh =
+            m_context.resources->GetMeshManager().Get(std::make_pair("assets/models/mycube.gltf", 0)).value();
+        meshComponent.texture = m_context.resources->GetTextureManager().Get("white").value();
+        meshComponent.mulColor = m_teamColors[context.castByPlayerStats->teamId];
     }
-    else // all other options other than self
+
+    const auto& playerPhysicsBody = m_registry.get<PhysicsBody2DComponent>(context.castByPlayer);
+    const auto& playerTransform = m_registry.get<TransformComponent>(context.castByPlayer);
+    const glm::vec2 direction2D = GetXZDirectionFromQuaternion(playerTransform.rotation);
+    physicsBody.velocity = direction2D * abilitySettings.projectileSpeed;
+    physicsBody.scale = abilitySettings.projectileRadius;
+    physicsBody.layer = CollisionLayer2D::Projectile;
+    physicsBody.position = playerPhysicsBody.position;
+    // special case where the cone is 360 degrees so the projectiles should not spawn in front of the player
+    if (!(are_floats_equal(abilitySettings.coneAngle, 2.f * pi) &&
+          abilitySettings.shootType == ProjectileShootType::Cone))
     {
-        switch (abilitySettings.castType)
-        {
-            case CastType::Projectile:
-            {
-                const auto mesh =
-                    Engine.ResourceManager().GetMeshManager().Get(std::make_pair("assets/models/mycube.gltf", 0)).value();
-                const auto texture = Engine.ResourceManager().GetTextureManager().Get("white").value();
-                MeshComponent meshComponent = {mesh, texture, m_teamColors[playerStats.teamId]};
-                auto abilityPhysicsBody = PhysicsBody2DComponent();
-                const auto& playerPhysicsBody = m_registry.get<PhysicsBody2DComponent>(abilityComponent.castByPlayer);
-                const auto& playerTransform = m_registry.get<TransformComponent>(abilityComponent.castByPlayer);
-                const glm::vec2 direction2D = GetXZDirectionFromQuaternion(playerTransform.rotation);
-                abilityPhysicsBody.velocity = direction2D * abilitySettings.projectileSpeed;
-                abilityPhysicsBody.scale = abilitySettings.projectileRadius;
-                abilityPhysicsBody.position = playerPhysicsBody.position;
-                // special case where the cone is 360 degrees so the projectiles should not spawn in front of the player
-                if (!(are_floats_equal(abilitySettings.coneAngle, 2.f * pi) &&
-                      abilitySettings.shootType == ProjectileShootType::Cone))
-                {
-                    const glm::vec2 spawnOffset = direction2D * (playerPhysicsBody.scale + abilityPhysicsBody.scale);
-                    abilityPhysicsBody.position += spawnOffset;
-                }
-                auto abilityTransform = TransformComponent();
-                abilityTransform.pos.y = playerTransform.pos.y;
-                abilityTransform.scale.y = abilitySettings.projectileRadius;
-
-                if (abilitySettings.numberOfProjectiles == 1)
-                {
-                    auto projectile = CreateProjectile(abilityComponent, meshComponent, abilityPhysicsBody, abilityTransform);
-                    AddToHierarchy(projectile, abilityName);
-                }
-                else
-                {
-                    switch (abilitySettings.shootType)
-                    {
-                        case ProjectileShootType::Cone:
-                        {
-                            const float angleBetweenProjectiles =
-                                abilitySettings.coneAngle / static_cast<float>(abilitySettings.numberOfProjectiles - 1);
-                            const glm::vec2 normalizedDir = normalize(abilityPhysicsBody.velocity);
-                            const float directionInRadians = atan2(normalizedDir.y, normalizedDir.x);
-                            const float firstProjectileAngle = directionInRadians - abilitySettings.coneAngle / 2.f;
-
-                            for (int i = 0; i < abilitySettings.numberOfProjectiles; i++)
-                            {
-                                auto projectile =
-                                    CreateProjectile(abilityComponent, meshComponent, abilityPhysicsBody, abilityTransform);
-
-                                // calculate direction
-                                auto& physicsBody = m_registry.get<PhysicsBody2DComponent>(projectile);
-                                const auto projectileAngle =
-                                    firstProjectileAngle + static_cast<float>(i) * angleBetweenProjectiles;
-                                physicsBody.velocity =
-                                    glm::vec2(cos(projectileAngle), sin(projectileAngle)) * length(physicsBody.velocity);
-
-                                AddToHierarchy(projectile, abilityName + std::to_string(i));
-                            }
-                            m_registry.destroy(ability);
-                            break;
-                        }
-                        case ProjectileShootType::Line:
-                        {
-                            auto projectile =
-                                CreateProjectile(abilityComponent, meshComponent, abilityPhysicsBody, abilityTransform);
-                            AddToHierarchy(projectile, abilityName + std::to_string(1));
-                            auto& projectileAbilityComponent = m_registry.get<AbilityComponent>(projectile);
-                            projectileAbilityComponent.firstProjectileInLine = true;
-                            m_registry.destroy(ability);
-                            break;
-                        }
-                    }
-                }
-                break;
-            }
-            case CastType::RadiusAroundPlayer:
-            {
-                auto& meshComponent = m_registry.emplace<MeshComponent>(ability);
-                meshComponent.mesh =
-                    Engine.ResourceManager().GetMeshManager().Get(std::make_pair("assets/models/cylinder.gltf", 0)).value();
-                meshComponent.texture = Engine.ResourceManager().GetTextureManager().Get("white").value();
-                meshComponent.mulColor = m_teamColors[playerStats.teamId];
-
-                auto& physicsBody = m_registry.emplace<PhysicsBody2DComponent>(ability);
-                const auto& playerPhysicsBody = m_registry.get<PhysicsBody2DComponent>(abilityComponent.castByPlayer);
-                physicsBody.position = playerPhysicsBody.position;
-                physicsBody.scale = abilitySettings.aoeRadius;
-
-                auto& transformComponent = m_registry.emplace<TransformComponent>(ability);
-                transformComponent.scale.y = 0.1f;
-
-                AddToHierarchy(ability, abilityName);
-                
-                abilityComponent.dead = true;
-                break;
-            }
-        }
+        const glm::vec2 spawnOffset = direction2D * (playerPhysicsBody.scale + physicsBody.scale);
+        physicsBody.position += spawnOffset;
+    }
+
+    transformComponent.pos.y = playerTransform.pos.y;
+    transformComponent.scale.y = abilitySettings.projectileRadius;
+}
+
+void bee::AbilitySystem::SpawnProjectileOp(OpContext& context)
+{
+    MeshComponent meshComponent;
+    PhysicsBody2DComponent physicsBody;
+    TransformComponent transformComponent;
+    PrepareProjectile(context, meshComponent, physicsBody, transformComponent);
+
+    const auto projectile = CreateProjectile(
+        AbilityComponent(context.castByPlayer, context.abilityID), meshComponent, physicsBody, transformComponent);
+    AddToHierarchy(projectile, m_abilityManager.GetName(context.abilityID));
+}
+
+void bee::AbilitySystem::SpawnProjectileConeOp(OpContext& context)
+{
+    const auto& abilitySettings = *context.ability;
+    MeshComponent meshComponent;
+    PhysicsBody2DComponent physicsBody;
+    TransformComponent transformComponent;
+    PrepareProjectile(context, meshComponent, physicsBody, transformComponent);
+
+    const AbilityComponent abilityComponent(context.castByPlayer, context.abilityID);
+    const auto& abilityName = m_abilityManager.GetName(context.abilityID);
+    const float speed = length(physicsBody.velocity);
+    const float angleBetweenProjectiles =
+        abilitySettings.coneAngle / static_cast<float>(abilitySettings.numberOfProjectiles - 1);
+    const glm::vec2 normalizedDir = normalize(physicsBody.velocity);
+    const float directionInRadians = atan2(normalizedDir.y, normalizedDir.x);
+    const float firstProjectileAngle = directionInRadians - abilitySettings.coneAngle / 2.f;
+
+    for (int i = 0; i < abilitySettings.numberOfProjectiles; i++)
+    {
+        // calculate direction
+        const auto projectileAngle = firstProjectileAngle + static_cast<float>(i) * angleBetweenProjectiles;
+        physicsBody.velocity = glm::vec2(cos(projectileAngle), sin(projectileAngle)) * speed;
+
+        const auto projectile = CreateProjectile(abilityComponent, meshComponent, physicsBody, transformComponent);
+        AddToHierarchy(projectile, abilityName + std::to_string(i));
+    }
+}
+
+void bee::AbilitySystem::SpawnProjectileLineOp(OpContext& context)
+{
+    MeshComponent meshComponent;
+    PhysicsBody2DComponent physicsBody;
+    TransformComponent transformComponent;
+    PrepareProjectile(context, meshComponent, physicsBody, transformComponent);
+
+    // the first projectile spawns the others once it has moved far enough
+    AbilityComponent abilityComponent(context.castByPlayer, context.abilityID);
+    abilityComponent.firstProjectileInLine = true;
+    const auto projectile = CreateProjectile(abilityComponent, meshComponent, physicsBody, transformComponent);
+    AddToHierarchy(
+        projectile, m_abilityManager.GetName(context.abilityID) + std::to_string(1));
+}
+
+void bee::AbilitySystem::SpawnAoeOp(OpContext& context)
+{
+    const auto& abilitySettings = *context.ability;
+    const auto ability = TakeFromPool();
+    if (!m_headless)
+    {
+        auto& meshComponent = m_registry.emplace<MeshComponent>(ability);
+        meshComponent.mesh =
+            m_context.resources->GetMeshManager().Get(std::make_pair("assets/models/cylinder.gltf", 0)).value();
+        meshComponent.texture = m_context.resources->GetTextureManager().Get("white").value();
+        meshComponent.mulColor = m_teamColors[context.castByPlayerStats->teamId];
     }
+
+    auto& physicsBody = m_registry.emplace<PhysicsBody2DComponent>(ability);
+    const auto& playerPhysicsBody = m_registry.get<PhysicsBody2DComponent>(context.castByPlayer);
+    physicsBody.position = playerPhysicsBody.position;
+    physicsBody.scale = abilitySettings.aoeRadius;
+    physicsBody.layer = CollisionLayer2D::AreaOfEffect;
+
+    auto& transformComponent = m_registry.emplace<TransformComponent>(ability);
+    transformComponent.scale.y = 0.1f;
+
+    AddToHierarchy(ability, m_abilityManager.GetName(context.abilityID));
+
+    auto& abilityComponent = m_registry.emplace<AbilityComponent>(ability, context.castByPlayer, context.abilityID);
+    abilityComponent.dead = true;
+
+    TimedEffect aoeEnd;
+    aoeEnd.type = TimedEffect::Type::AoeEnd;
+    aoeEnd.time = m_time + abilitySettings.aoeDuration;
+    aoeEnd.target = ability;
+    m_timedEffects.Schedule(aoeEnd.time, aoeEnd);
+}
+
+void bee::AbilitySystem::ApplyAmountToHitPlayerOp(OpContext& context)
+{
+    context.applied = ApplyAmount(*context.ability, context.hitPlayer, *context.hitPlayerStats, *context.castByPlayerStats);
+}
+
+void bee::AbilitySystem::ApplyStatusEffectToHitPlayerOp(OpContext& context)
+{
+    ApplyStatusEffect(*context.ability, context.hitPlayer, *context.hitPlayerStats);
+}
+
+void bee::AbilitySystem::ScheduleDurationOnHitPlayerOp(OpContext& context)
+{
+    ScheduleDurationalEffect(context.abilityID, *context.ability, context.castByPlayer, context.hitPlayer, context.applied);
 }
 
-std::pair<float&, float&> bee::AbilitySystem::GetStat(const Stat stat, PlayerStatsComponent& playerStats)
+void bee::AbilitySystem::StopProjectileOp(OpContext& context)
 {
-    switch (stat)
+    DestroyOrEraseComponentsBasedOnFirstProjectileInLine(context.abilityEntity, *context.abilityComponent);
+}
+
+void bee::AbilitySystem::AdvanceProjectileOp(OpContext& context)
+{
+    auto& abilityComponent = *context.abilityComponent;
+    // update projectile range
+    const bool maxRangeReached = abilityComponent.currentProjectileRange >= context.ability->projectileRange;
+    if (maxRangeReached && !abilityComponent.dead)
     {
-        case Stat::Health:
-            return {playerStats.currentHealth, playerStats.baseHealth};
-        case Stat::Ammo:
-            return {playerStats.currentAmmo, playerStats.baseAmmo};
-        case Stat::ReloadSpeed:
-            return {playerStats.currentReloadSpeed, playerStats.baseReloadSpeed};
-        case Stat::MovementSpeed:
-            return {playerStats.currentMovementSpeed, playerStats.baseMovementSpeed};
-        case Stat::DealtDamageModifier:
-            return {playerStats.currentDealtDamageModifier, playerStats.baseDealtDamageModifier};
-        case Stat::ReceivedDamageReduction:
-            return {playerStats.currentReceivedDamageReduction, playerStats.baseReceivedDamageReduction};
+        DestroyOrEraseComponentsBasedOnFirstProjectileInLine(context.abilityEntity, abilityComponent);
+        if (!m_registry.all_of<AbilityComponent>(context.abilityEntity))
+            return; // released to the pool
     }
+    abilityComponent.currentProjectileRange += context.ability->projectileSpeed * context.dt;
+}
 
-    // added this just because the compiler was complaining that somehow
-    // not all control paths return a value
-    return {playerStats.currentHealth, playerStats.baseHealth};
+void bee::AbilitySystem::SpawnNextProjectileInLineOp(OpContext& context)
+{
+    if (context.abilityComponent->firstProjectileInLine)
+        ProjectilesInLineLogic(context.abilityEntity, *context.abilityComponent);
 }
 
-void bee::AbilitySystem::ApplyAmount(
-    const AbilitySettings& ability, PlayerStatsComponent& hitPlayerStats, const PlayerStatsComponent& castByPlayerStats,
-    const bool revert)
+void bee::AbilitySystem::DisableAoeCollisionOp(OpContext& context)
+{
+    // an aoe ability only gets one physics update to hit players, delete the physics body
+    // so it cannot register more collisions
+    m_registry.remove<PhysicsBody2DComponent>(context.abilityEntity);
+}
+
+bee::AbilitySystem::AppliedAmount bee::AbilitySystem::ApplyAmount(
+    const AbilitySettings& ability, const entt::entity hitPlayer, PlayerStatsComponent& hitPlayerStats,
+    const PlayerStatsComponent& castByPlayerStats)
 {
     if (hitPlayerStats.state & PlayerStatsComponent::State::Invincible &&
         ability.increaseOrDecrease == IncreaseOrDecrease::Decrease)
     {
-        return; // do not apply any negative effects
+        return {}; // do not apply any negative effects
+    }
+
+    if (ability.applyType != ApplyType::StatusEffect)
+    {
+        AddVisualEffectForApplyAmount(ability, hitPlayer, hitPlayerStats);
     }
 
-    auto [current, base] = GetStat(ability.statAffected, hitPlayerStats);
-    float amount = ability.statAffectAmount;
+    const float sign = ability.increaseOrDecrease == IncreaseOrDecrease::Decrease ? -1.f : 1.f;
+    const auto& [currentField, baseField] = GetStatFields(ability.statAffected);
+    AppliedAmount applied;
 
-    if (ability.appliedAs == AppliedAs::Percentage)
+    if (IsPoolStat(ability.statAffected))
     {
-        if (ability.statAffected != Stat::DealtDamageModifier && ability.statAffected != Stat::ReceivedDamageReduction)
+        float& current = hitPlayerStats.*currentField;
+        const float base = hitPlayerStats.*baseField;
+
+        float amount = ability.statAffectAmount;
+        if (ability.appliedAs == AppliedAs::Percentage)
             amount = base * (amount / 100.f);
-        else
-            amount = amount / 100.f;
+
+        if (ability.statAffected == Stat::Health)
+        {
+            const float damageModifier =
+                castByPlayerStats.currentDealtDamageModifier - hitPlayerStats.currentReceivedDamageReduction;
+            amount += amount * damageModifier;
+        }
+
+        // apply
+        const float previous = current;
+        current = std::max(current + sign * amount, 0.0f);
+        if (ability.clampToMax)
+            current = std::min(current, base);
+        applied.delta = current - previous;
+        return applied;
     }
 
-    if (ability.statAffected == Stat::Health)
+    StatModifiersComponent::Modifier modifier;
+    modifier.clampToMax = ability.clampToMax;
+    // the damage modifiers are already fractions, a percentage of them is added as is
+    const bool isDamageModifier =
+        ability.statAffected == Stat::DealtDamageModifier || ability.statAffected == Stat::ReceivedDamageReduction;
+    if (ability.appliedAs == AppliedAs::Flat)
+        modifier.flat = sign * ability.statAffectAmount;
+    else if (isDamageModifier)
+        modifier.flat = sign * ability.statAffectAmount / 100.f;
+    else
+        modifier.percentage = sign * ability.statAffectAmount / 100.f;
+
+    auto& modifiers = m_registry.get_or_emplace<StatModifiersComponent>(hitPlayer);
+    const auto statIndex = static_cast<size_t>(ability.statAffected);
+    if (ability.applyType == ApplyType::BuffDebuff)
     {
-        const float damageModifier =
-            castByPlayerStats.currentDealtDamageModifier - hitPlayerStats.currentReceivedDamageReduction;
-        amount += amount * damageModifier;
+        modifier.handle = modifiers.nextHandle++;
+        modifiers.stacks[statIndex].push_back(modifier);
+        applied.handle = modifier.handle;
     }
-
-    if (ability.increaseOrDecrease == IncreaseOrDecrease::Decrease)
+    else
     {
-        amount = -amount;
+        auto& permanent = modifiers.permanent[statIndex];
+        permanent.flat += modifier.flat;
+        permanent.percentage += modifier.percentage;
+        permanent.clampToMax |= modifier.clampToMax;
     }
+    modifiers.MarkDirty(ability.statAffected);
+    return applied;
+}
 
-    if (revert)
+void bee::AbilitySystem::RevertAmount(
+    const AbilitySettings& ability, const entt::entity player, PlayerStatsComponent& playerStats,
+    const AppliedAmount& applied)
+{
+    if (IsPoolStat(ability.statAffected))
     {
-        amount = -amount;
+        const auto& [currentField, baseField] = GetStatFields(ability.statAffected);
+        float& current = playerStats.*currentField;
+        current = std::max(current - applied.delta, 0.0f);
+        if (ability.clampToMax)
+            current = std::min(current, playerStats.*baseField);
+        return;
     }
-    else if (ability.applyType != ApplyType::StatusEffect)
+
+    auto* modifiers = m_registry.try_get<StatModifiersComponent>(player);
+    if (modifiers == nullptr || applied.handle == 0)
+        return; // nothing was applied, the player was invincible
+
+    auto& stack = modifiers->stacks[static_cast<size_t>(ability.statAffected)];
+    const auto modifier = std::find_if(
+        stack.begin(), stack.end(),
+        [&applied](const StatModifiersComponent::Modifier& m) { return m.handle == applied.handle; });
+    if (modifier == stack.end())
+        return;
+    *modifier = stack.back();
+    stack.pop_back();
+    modifiers->MarkDirty(ability.statAffected);
+}
+
+void bee::AbilitySystem::RefreshDirtyStats()
+{
+    auto view = m_registry.view<StatModifiersComponent, PlayerStatsComponent>();
+    for (auto [entity, modifiers, playerStats] : view.each())
     {
-        AddVisualEffectForApplyAmount(ability, hitPlayerStats);
-    }
+        if (modifiers.dirtyStats == 0)
+            continue;
 
-    // apply
-    current += amount;
-    current = std::max(current, 0.0f);
-    if (ability.clampToMax)
-        current = std::min(current, base);
+        for (size_t statIndex = 0; statIndex < StatModifiersComponent::STAT_COUNT; statIndex++)
+        {
+            const auto stat = static_cast<Stat>(statIndex);
+            if (!modifiers.IsDirty(stat))
+                continue;
+
+            // summed from the same values every time, so overlapping buffs do not leave any drift behind
+            const auto& permanent = modifiers.permanent[statIndex];
+            float flat = permanent.flat;
+            float percentage = permanent.percentage;
+            bool clampToMax = permanent.clampToMax;
+            for (const auto& modifier : modifiers.stacks[statIndex])
+            {
+                flat += modifier.flat;
+                percentage += modifier.percentage;
+                clampToMax |= modifier.clampToMax;
+            }
+
+            const auto& [currentField, baseField] = GetStatFields(stat);
+            const float base = playerStats.*baseField;
+            float current = std::max((base + flat) * (1.f + percentage), 0.0f);
+            if (clampToMax)
+                current = std::min(current, base);
+            playerStats.*currentField = current;
+        }
+        modifiers.dirtyStats = 0;
+    }
 }
 
-void bee::AbilitySystem::ApplyStatusEffect(const AbilitySettings& ability, PlayerStatsComponent& playerStats)
+void bee::AbilitySystem::ApplyStatusEffect(
+    const AbilitySettings& ability, const entt::entity player, PlayerStatsComponent& playerStats)
 {
     if (playerStats.state & PlayerStatsComponent::State::Invincible &&
         ability.statusEffectType != StatusEffectType::Invincibility)
@@ -566,68 +578,95 @@ void bee::AbilitySystem::ApplyStatusEffect(const AbilitySettings& ability, Playe
         return; // do not apply any negative effects
     }
 
-    AddVisualEffectForStatusEffect(ability, playerStats);
+    AddVisualEffectForStatusEffect(ability, player, playerStats);
     playerStats.state |= 1 << static_cast<unsigned>(ability.statusEffectType);
 }
 
+entt::entity bee::AbilitySystem::GetTheoreticalRoot()
+{
+    // the root only changes when a scene is loaded, so it is looked up once instead of for every ability
+    if (!m_registry.valid(m_theoreticalRoot) || !m_registry.all_of<TheoreticalRootComponent>(m_theoreticalRoot))
+        m_theoreticalRoot = m_registry.view<TheoreticalRootComponent>().front();
+    return m_theoreticalRoot;
+}
+
 void bee::AbilitySystem::AddToHierarchy(entt::entity entity, const std::string& name)
 {
-    auto theoreticalRootView = m_registry.view<TheoreticalRootComponent>();
-    auto& rootHierarchyComponent = m_registry.get<HierarchyComponent>(theoreticalRootView.front());
-    m_registry.emplace<RootComponent>(entity);
-    auto& hierarchyComponent = m_registry.emplace<HierarchyComponent>(entity);
-    hierarchyComponent.parent = theoreticalRootView.front();
-    rootHierarchyComponent.children.push_back(entity);
-    m_registry.emplace<NameComponent>(entity, name);
+    if (m_headless)
+        return; // there is no hierarchy to show it in
+
+    m_registry.emplace_or_replace<RootComponent>(entity);
+    AttachToParent(m_registry, entity, GetTheoreticalRoot());
+    // pooled projectiles keep their name component, assigning reuses the string
+    m_registry.get_or_emplace<NameComponent>(entity).name = name;
 }
 
 void bee::AbilitySystem::RemoveFromHierarchy(entt::entity entity)
 {
-    auto theoreticalRootView = m_registry.view<TheoreticalRootComponent>();
-    auto& rootHierarchyComponent = m_registry.get<HierarchyComponent>(theoreticalRootView.front());
-    for (auto it = rootHierarchyComponent.children.begin(); it != rootHierarchyComponent.children.end(); ++it)
-    {
-        if (*it == entity)
-        {
-            rootHierarchyComponent.children.erase(it);
-            break;
-        }
-    }
+    if (!m_registry.all_of<HierarchyComponent>(entity))
+        return; // never added, or headless
+
+    DetachFromParent(m_registry, entity);
+    m_registry.remove<RootComponent>(entity);
 }
 
 entt::entity bee::AbilitySystem::CreateProjectile(const AbilityComponent& abilityComponent, const MeshComponent& meshComponent,
     const PhysicsBody2DComponent& physicsBody, const TransformComponent& transformComponent)
 {
-    auto projectile = m_registry.create();
+    const auto projectile = TakeFromPool();
     m_registry.emplace<AbilityComponent>(projectile, abilityComponent);
-    m_registry.emplace<MeshComponent>(projectile, meshComponent);
+    if (!m_headless)
+        m_registry.emplace<MeshComponent>(projectile, meshComponent);
     m_registry.emplace<PhysicsBody2DComponent>(projectile, physicsBody);
     m_registry.emplace<TransformComponent>(projectile, transformComponent);
 
     return projectile;
 }
 
+entt::entity bee::AbilitySystem::TakeFromPool()
+{
+    while (!m_abilityPool.empty())
+    {
+        const auto entity = m_abilityPool.back();
+        m_abilityPool.pop_back();
+        // pooled entities are destroyed when the scene is saved
+        if (m_registry.valid(entity))
+        {
+            m_registry.remove<PooledAbilityComponent>(entity);
+            return entity;
+        }
+    }
+    return m_registry.create();
+}
+
+void bee::AbilitySystem::ReleaseToPool(entt::entity entity)
+{
+    RemoveFromHierarchy(entity);
+    m_registry.remove<AbilityComponent, MeshComponent, PhysicsBody2DComponent, TransformComponent>(entity);
+    m_registry.emplace<PooledAbilityComponent>(entity);
+    m_abilityPool.push_back(entity);
+}
+
 void bee::AbilitySystem::DestroyOrEraseComponentsBasedOnFirstProjectileInLine(
     entt::entity ability, AbilityComponent& abilityComponent)
 {
     if (!abilityComponent.firstProjectileInLine)
     {
-        RemoveFromHierarchy(ability);
-        m_registry.destroy(ability);
+        ReleaseToPool(ability);
     }
     else if (abilityComponent.firstProjectileInLine)
     {
         RemoveFromHierarchy(ability);
-        // do not destroy the first projectile until
+        // do not release the first projectile until
         // all the other projectiles in the line have been spawned
-        m_registry.erase<HierarchyComponent, MeshComponent, TransformComponent>(ability);
+        m_registry.remove<MeshComponent, TransformComponent, PhysicsBody2DComponent>(ability);
         abilityComponent.dead = true;
     }
 }
 
 void bee::AbilitySystem::ProjectilesInLineLogic(entt::entity ability, AbilityComponent& abilityComponent)
 {
-    auto& abilitySettings = abilityComponent.settings;
+    const auto& abilitySettings = m_abilityManager.Get(abilityComponent.abilityID);
     if (static_cast<int>(
             abilityComponent.currentProjectileRange /
             (abilitySettings.projectileRadius * 2.f + abilitySettings.spaceBetweenProjectiles)) >=
@@ -636,27 +675,15 @@ void bee::AbilitySystem::ProjectilesInLineLogic(entt::entity ability, AbilityCom
     {
         abilityComponent.currentNumberOfProjectiles++;
 
-        const auto mesh = Engine.ResourceManager()
-                              .GetMeshManager()
-                              .Get(std::make_pair("assets/models/mycube.gltf", 0))
-                              .value(); // NOLINT(bugprone-unchecked-optional-access)
-        const auto texture = Engine.ResourceManager()
-                                 .GetTextureManager()
-                                 .Get("white")
-                                 .value(); // NOLINT(bugprone-unchecked-optional-access)
-        const auto& playerStats = m_registry.get<PlayerStatsComponent>(abilityComponent.castByPlayer);
-        MeshComponent newProjectileMeshComponent = {mesh, texture, m_teamColors[playerStats.teamId]};
-        auto newProjectilePhysicsBody = PhysicsBody2DComponent();
-        const auto& playerPhysicsBody = m_registry.get<PhysicsBody2DComponent>(abilityComponent.castByPlayer);
-        const auto& playerTransform = m_registry.get<TransformComponent>(abilityComponent.castByPlayer);
-        const glm::vec2 direction2D = GetXZDirectionFromQuaternion(playerTransform.rotation);
-        newProjectilePhysicsBody.velocity = direction2D * abilitySettings.projectileSpeed;
-        newProjectilePhysicsBody.scale = abilitySettings.projectileRadius;
-        const glm::vec2 spawnOffset = direction2D * (playerPhysicsBody.scale + newProjectilePhysicsBody.scale);
-        newProjectilePhysicsBody.position = playerPhysicsBody.position + spawnOffset;
-        auto newProjectileTransform = TransformComponent();
-        newProjectileTransform.pos.y = playerTransform.pos.y;
-        newProjectileTransform.scale.y = abilitySettings.projectileRadius;
+        OpContext context;
+        context.abilityID = abilityComponent.abilityID;
+        context.ability = &abilitySettings;
+        context.castByPlayer = abilityComponent.castByPlayer;
+        context.castByPlayerStats = &m_registry.get<PlayerStatsComponent>(abilityComponent.castByPlayer);
+        MeshComponent newProjectileMeshComponent;
+        PhysicsBody2DComponent newProjectilePhysicsBody;
+        TransformComponent newProjectileTransform;
+        PrepareProjectile(context, newProjectileMeshComponent, newProjectilePhysicsBody, newProjectileTransform);
 
         auto newProjectile =
             CreateProjectile(abilityComponent, newProjectileMeshComponent, newProjectilePhysicsBody, newProjectileTransform);
@@ -664,21 +691,19 @@ void bee::AbilitySystem::ProjectilesInLineLogic(entt::entity ability, AbilityCom
         newProjectileAbilityComponent.firstProjectileInLine = false;
         newProjectileAbilityComponent.dead = false;
         newProjectileAbilityComponent.currentProjectileRange = 0.0f;
-        newProjectileAbilityComponent.currentDurationAmount = newProjectileAbilityComponent.settings.durationAmount;
-        auto name = m_registry.get<NameComponent>(ability).name;
-        name = StringRemove(name, "1");
-        AddToHierarchy(newProjectile, name + std::to_string(abilityComponent.currentNumberOfProjectiles));
+        AddToHierarchy(
+            newProjectile, m_abilityManager.GetName(abilityComponent.abilityID) +
+                               std::to_string(abilityComponent.currentNumberOfProjectiles));
     }
     if (abilityComponent.currentNumberOfProjectiles >= abilitySettings.numberOfProjectiles &&
         abilityComponent.currentProjectileRange >= abilitySettings.projectileRange)
     {
-        m_registry.destroy(ability);
-        if (!abilityComponent.dead)
-            RemoveFromHierarchy(ability);
+        ReleaseToPool(ability);
     }
 }
 
-void bee::AbilitySystem::AddVisualEffectForApplyAmount(const AbilitySettings& ability, PlayerStatsComponent& playerStats)
+void bee::AbilitySystem::AddVisualEffectForApplyAmount(
+    const AbilitySettings& ability, const entt::entity player, PlayerStatsComponent& playerStats)
 {
     glm::vec4 color;
     if (const auto it = m_statColors.find(std::make_pair(ability.statAffected, ability.increaseOrDecrease));
@@ -693,22 +718,166 @@ void bee::AbilitySystem::AddVisualEffectForApplyAmount(const AbilitySettings& ab
 
     if (ability.applyType == ApplyType::Instant || ability.applyType == ApplyType::EffectOverTime)
     {
-        playerStats.visualEffects.emplace_back(color);
+        AddVisualEffect(player, playerStats, PlayerStatsComponent::VisualEffect(color));
     }
     else
     {
-        playerStats.visualEffects.emplace_back(ability.durationAmount, color);
+        AddVisualEffect(player, playerStats, PlayerStatsComponent::VisualEffect(ability.durationAmount, color));
     }
 }
 
-void bee::AbilitySystem::AddVisualEffectForStatusEffect(const AbilitySettings& ability, PlayerStatsComponent& playerStats)
+void bee::AbilitySystem::AddVisualEffectForStatusEffect(
+    const AbilitySettings& ability, const entt::entity player, PlayerStatsComponent& playerStats)
 {
     if (ability.statusEffectType == StatusEffectType::Invincibility)
     {
-        playerStats.visualEffects.emplace_back(ability.durationAmount, m_invincibilityColor);
+        AddVisualEffect(player, playerStats, PlayerStatsComponent::VisualEffect(ability.durationAmount, m_invincibilityColor));
     }
     else
     {
-        playerStats.visualEffects.emplace_back(ability.durationAmount, m_stunRootSilenceColor);
+        AddVisualEffect(
+            player, playerStats, PlayerStatsComponent::VisualEffect(ability.durationAmount, m_stunRootSilenceColor));
+    }
+}
+
+void bee::AbilitySystem::AddVisualEffect(
+    const entt::entity player, PlayerStatsComponent& playerStats, PlayerStatsComponent::VisualEffect visualEffect)
+{
+    visualEffect.endTime = m_time + visualEffect.duration;
+    playerStats.visualEffects.push_back(visualEffect);
+    if (auto* mesh = m_registry.try_get<MeshComponent>(player))
+    {
+        mesh->mulColor = visualEffect.color;
+    }
+
+    TimedEffect visualEffectEnd;
+    visualEffectEnd.type = TimedEffect::Type::VisualEffectEnd;
+    visualEffectEnd.time = visualEffect.endTime;
+    visualEffectEnd.target = player;
+    m_timedEffects.Schedule(visualEffectEnd.time, visualEffectEnd);
+}
+
+void bee::AbilitySystem::RemoveEndedVisualEffects(
+    const entt::entity player, PlayerStatsComponent& playerStats, const double time)
+{
+    auto& visualEffects = playerStats.visualEffects;
+    visualEffects.erase(
+        std::remove_if(
+            visualEffects.begin(), visualEffects.end(),
+            [time](const PlayerStatsComponent::VisualEffect& visualEffect) { return visualEffect.endTime <= time; }),
+        visualEffects.end());
+
+    // the newest effect that is still going decides the color
+    if (auto* mesh = m_registry.try_get<MeshComponent>(player))
+    {
+        mesh->mulColor = visualEffects.empty() ? m_teamColors[playerStats.teamId] : visualEffects.back().color;
+    }
+}
+
+void bee::AbilitySystem::ScheduleDurationalEffect(
+    const AbilityID abilityID, const AbilitySettings& ability, const entt::entity castByPlayer, const entt::entity hitPlayer,
+    const AppliedAmount& applied)
+{
+    TimedEffect timedEffect;
+    timedEffect.time = m_time + ability.durationAmount;
+    timedEffect.abilityID = abilityID;
+    timedEffect.castByPlayer = castByPlayer;
+    timedEffect.target = hitPlayer;
+    timedEffect.applied = applied;
+
+    switch (ability.applyType)
+    {
+        case ApplyType::Instant:
+        {
+            return;
+        }
+        case ApplyType::EffectOverTime:
+        {
+            // the first tick was applied on hit
+            if (ability.numberOfTicks <= 1)
+                return;
+            timedEffect.type = TimedEffect::Type::Tick;
+            timedEffect.remainingTicks = ability.numberOfTicks - 1;
+            break;
+        }
+        case ApplyType::BuffDebuff:
+        {
+            timedEffect.type = TimedEffect::Type::Revert;
+            break;
+        }
+        case ApplyType::StatusEffect:
+        {
+            timedEffect.type = TimedEffect::Type::StatusEffectEnd;
+            break;
+        }
+    }
+    m_timedEffects.Schedule(timedEffect.time, timedEffect);
+}
+
+void bee::AbilitySystem::FireTimedEffect(const TimedEffect& timedEffect)
+{
+    if (!m_registry.valid(timedEffect.target))
+        return; // the player or the aoe is gone
+
+    if (timedEffect.type == TimedEffect::Type::AoeEnd)
+    {
+        ReleaseToPool(timedEffect.target);
+        return;
+    }
+
+    auto* playerStats = m_registry.try_get<PlayerStatsComponent>(timedEffect.target);
+    if (playerStats == nullptr)
+        return;
+
+    // the caster might have been deleted in the meantime, the damage modifier then comes from the target itself
+    const PlayerStatsComponent* castByPlayerStats = m_registry.valid(timedEffect.castByPlayer)
+                                                        ? m_registry.try_get<PlayerStatsComponent>(timedEffect.castByPlayer)
+                                                        : nullptr;
+    if (castByPlayerStats == nullptr)
+        castByPlayerStats = playerStats;
+
+    switch (timedEffect.type)
+    {
+        case TimedEffect::Type::Tick:
+        {
+            ApplyAmount(m_abilityManager.Get(timedEffect.abilityID), timedEffect.target, *playerStats, *castByPlayerStats);
+            if (timedEffect.remainingTicks > 1)
+            {
+                // scheduled from the time it was due, so late frames do not make the ticks drift
+                TimedEffect nextTick = timedEffect;
+                nextTick.time += m_abilityManager.Get(timedEffect.abilityID).durationAmount;
+                nextTick.remainingTicks--;
+                m_timedEffects.Schedule(nextTick.time, nextTick);
+            }
+            break;
+        }
+        case TimedEffect::Type::Revert:
+        {
+            RevertAmount(m_abilityManager.Get(timedEffect.abilityID), timedEffect.target, *playerStats, timedEffect.applied);
+            break;
+        }
+        case TimedEffect::Type::StatusEffectEnd:
+        {
+            playerStats->state &= ~(1 << static_cast<unsigned>(m_abilityManager.Get(timedEffect.abilityID).statusEffectType));
+            break;
+        }
+        case TimedEffect::Type::DashEnd:
+        {
+            if (auto* playerPhysicsBody = m_registry.try_get<PhysicsBody2DComponent>(timedEffect.target))
+            {
+                playerPhysicsBody->velocity = glm::vec2(0.f);
+            }
+            playerStats->state &= ~PlayerStatsComponent::State::Dashing; // dashing off
+            break;
+        }
+        case TimedEffect::Type::VisualEffectEnd:
+        {
+            RemoveEndedVisualEffects(timedEffect.target, *playerStats, timedEffect.time);
+            break;
+        }
+        case TimedEffect::Type::AoeEnd:
+        {
+            break;
+        }
     }
 }
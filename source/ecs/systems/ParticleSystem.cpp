@@ -1,24 +1,90 @@
 #include "ecs/systems/ParticleSystem.h"
 
+#include <algorithm>
 #include <imgui.h>
 #include <glm/gtc/type_ptr.inl>
 #include <glm/gtx/compatibility.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 
 #include "tools/tools.hpp"
 #include "core/input.hpp"
 #include "core/engine.hpp"
 #include "resource_managers/ResourceManager.h"
 #include "tools/MainMenuBar.h"
+#include "tools/ImGuiHelpers.h"
 
 #include "ecs/components/ParticleSystemComponents.h"
 #include "ecs/components/TransformComponent.h"
+#include "ecs/systems/PhysicsGridSnapshot2D.h"
+#include "ecs/WorldContext.h"
+
+namespace
+{
+bool EditKeyValue(glm::vec4& value)
+{
+    return ImGui::ColorEdit4("##value", glm::value_ptr(value), ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_AlphaBar);
+}
+
+bool EditKeyValue(float& value) { return ImGui::DragFloat("##value", &value, 0.01f, 0.f, 10.f); }
+
+/**
+ * \brief Lists the keys of a curve with widgets to move, edit, add and remove them.
+ * \return Whether the curve has changed and needs to be baked again.
+ */
+template <typename T>
+bool CurveEditor(const char* label, bee::Curve<T>& curve)
+{
+    if (!ImGui::TreeNodeEx(label, ImGuiTreeNodeFlags_DefaultOpen))
+        return false;
+
+    bool changed = false;
+    int toRemove = -1;
+    for (int i = 0; i < static_cast<int>(curve.keys.size()); i++)
+    {
+        auto& key = curve.keys[i];
+        ImGui::PushID(i);
+        ImGui::SetNextItemWidth(100.f);
+        changed |= ImGui::SliderFloat("##time", &key.time, 0.f, 1.f, "age %.2f");
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(100.f);
+        changed |= EditKeyValue(key.value);
+        if (curve.keys.size() > 1)
+        {
+            ImGui::SameLine();
+            if (ImGui::SmallButton("x"))
+                toRemove = i;
+        }
+        ImGui::PopID();
+    }
+
+    if (toRemove != -1)
+    {
+        curve.keys.erase(curve.keys.begin() + toRemove);
+        changed = true;
+    }
+
+    if (ImGui::SmallButton("Add key"))
+    {
+        // split the last segment, so the new key doesn't change the shape of the curve
+        const size_t count = curve.keys.size();
+        const float time = count >= 2 ? (curve.keys[count - 2].time + curve.keys[count - 1].time) * 0.5f : 0.5f;
+        curve.keys.push_back({time, curve.Evaluate(time)});
+        curve.SortKeys();
+        changed = true;
+    }
+
+    ImGui::TreePop();
+    return changed;
+}
+} // namespace
 
 namespace bee
 {
 ParticleSystem::ParticleSystem(entt::registry& registry) : BaseSystem(registry)
 {
-    m_mesh.mesh = Engine.ResourceManager().GetMeshManager().Get("cube").value();
-    m_mesh.texture = Engine.ResourceManager().GetTextureManager().Get("white").value();
+    auto& resources = *registry.ctx().get<WorldContext>().resources;
+    m_mesh.mesh = resources.GetMeshManager().Get("cube").value();
+    m_mesh.texture = resources.GetTextureManager().Get("white").value();
 }
 
 void ParticleSystem::CreateEmitter(const MeshComponent& mesh) const
@@ -33,21 +99,23 @@ void ParticleSystem::CreateEmitter(const MeshComponent& mesh) const
     //meshComponent.texture = mesh.texture;
 }
 
-void ParticleSystem::AddParticle(const entt::entity& emitter) const
+void ParticleSystem::AddParticle(const entt::entity& emitter, const glm::vec2& spread)
 {
     const entt::entity particle = m_registry.create();
 
     auto& particleComponent = m_registry.emplace<ParticleComponent>(particle);
     m_registry.emplace<EmptyParticleComponent>(particle);
-    const auto& particleConfigComponent = m_registry.get<ParticleConfigComponent>(emitter);
-    particleComponent.dir = glm::normalize(
-        particleConfigComponent.dir + glm::vec3(bee::RandomFloatBtwnMinus1and1(), 0.f, bee::RandomFloatBtwnMinus1and1()));
+    auto& particleConfigComponent = m_registry.get<ParticleConfigComponent>(emitter);
+    if (particleConfigComponent.bakedCurves == nullptr)
+        BakeCurves(particleConfigComponent);
+    particleComponent.dir = glm::normalize(particleConfigComponent.dir + glm::vec3(spread.x, 0.f, spread.y));
     particleComponent.gravity = particleConfigComponent.gravity;
     particleComponent.speed = particleConfigComponent.speed;
-    particleComponent.colorBegin = particleConfigComponent.colorBegin;
-    particleComponent.colorEnd = particleConfigComponent.colorEnd;
-    particleComponent.scaleBegin = particleConfigComponent.scaleBegin;
-    particleComponent.scaleEnd = particleConfigComponent.scaleEnd;
+    particleComponent.curves = particleConfigComponent.bakedCurves;
+    particleComponent.collision = particleConfigComponent.collision;
+    particleComponent.collideWithBodies = particleConfigComponent.collideWithBodies;
+    particleComponent.groundHeight = particleConfigComponent.groundHeight;
+    particleComponent.restitution = particleConfigComponent.restitution;
     particleComponent.lifeSpan = particleConfigComponent.lifeSpan;
     particleComponent.currentLife = particleConfigComponent.lifeSpan;
 
@@ -61,13 +129,57 @@ void ParticleSystem::AddParticle(const entt::entity& emitter) const
     // transformComponent.rotation = normalize(transformComponent.rotation);
     transformComponent.scale *= emitterTransformComponent.scale;
     particleComponent.scaleBegin = transformComponent.scale;
+    transformComponent.scale *= particleComponent.curves->scale.Sample(0.f);
 
     auto& meshComponent = m_registry.emplace<MeshComponent>(particle, m_mesh/*m_registry.get<MeshComponent>(emitter)*/);
-    meshComponent.addColor = particleComponent.colorBegin;
+    meshComponent.addColor = particleComponent.curves->color.Sample(0.f);
+}
+
+bool ParticleSystem::Collide(
+    ParticleComponent& particle, TransformComponent& transform, const PhysicsGridSnapshot2D* physicsSnapshot)
+{
+    if (transform.pos.y < particle.groundHeight)
+    {
+        if (particle.collision == ParticleCollision::Kill)
+            return false;
+
+        transform.pos.y = particle.groundHeight;
+        if (particle.dir.y < 0.f)
+            particle.dir.y = -particle.dir.y * particle.restitution;
+    }
+
+    if (particle.collideWithBodies && physicsSnapshot != nullptr)
+    {
+        if (const auto* body = physicsSnapshot->FindBody(transform.pos))
+        {
+            if (particle.collision == ParticleCollision::Kill)
+                return false;
+
+            // push the particle out to the side of the cylinder and reflect the horizontal velocity
+            const glm::vec2 offset = glm::vec2(transform.pos.x, transform.pos.z) - body->position;
+            const float distance = glm::length(offset);
+            const glm::vec2 normal = distance > 0.f ? offset / distance : glm::vec2(1.f, 0.f);
+            const glm::vec2 pushedOut = body->position + normal * body->radius;
+            transform.pos.x = pushedOut.x;
+            transform.pos.z = pushedOut.y;
+
+            glm::vec2 velocity(particle.dir.x, particle.dir.z);
+            const float intoBody = glm::dot(velocity, normal);
+            if (intoBody < 0.f)
+                velocity -= (1.f + particle.restitution) * intoBody * normal;
+            particle.dir.x = velocity.x;
+            particle.dir.z = velocity.y;
+        }
+    }
+
+    return true;
 }
 
-void ParticleSystem::UpdateOneStep(const float& dt) const
+void ParticleSystem::UpdateOneStep(const float& dt)
 {
+    // published by PhysicsSystem2D last frame, looked up once so the loop stays free of registry lookups
+    const auto* physicsSnapshot = m_registry.ctx().find<PhysicsGridSnapshot2D>();
+
     const auto particleView = m_registry.view<ParticleComponent, TransformComponent, MeshComponent>();
     for (auto [particle, particleComponent, transformComponent, meshComponent] : particleView.each())
     {
@@ -77,9 +189,16 @@ void ParticleSystem::UpdateOneStep(const float& dt) const
             particleComponent.dir.y -= particleComponent.gravity * dt;
             // particleComponent.dir = normalize(particleComponent.dir);
             transformComponent.pos += particleComponent.dir * particleComponent.speed * dt;
-            const float& lerpStep = particleComponent.currentLife / particleComponent.lifeSpan;
-            meshComponent.addColor = glm::lerp(particleComponent.colorEnd, particleComponent.colorBegin, lerpStep);
-            transformComponent.scale = glm::lerp(particleComponent.scaleEnd, particleComponent.scaleBegin, lerpStep);
+            if (particleComponent.collision != ParticleCollision::None &&
+                !Collide(particleComponent, transformComponent, physicsSnapshot))
+            {
+                m_registry.destroy(particle);
+                continue;
+            }
+
+            const float age = 1.f - particleComponent.currentLife / particleComponent.lifeSpan;
+            meshComponent.addColor = particleComponent.curves->color.Sample(age);
+            transformComponent.scale = particleComponent.scaleBegin * particleComponent.curves->scale.Sample(age);
         }
         else
         {
@@ -94,6 +213,14 @@ void ParticleSystem::UpdateOneStep(const float& dt) const
             emitterComponent.currentLife -= dt;
         if (emitterComponent.currentLife >= 0 || emitterComponent.endless)
         {
+            if (emitterComponent.stateless)
+            {
+                AdvanceStatelessEmitter(emitter, dt);
+                continue;
+            }
+            if (m_registry.all_of<StatelessParticlesComponent>(emitter))
+                m_registry.erase<StatelessParticlesComponent>(emitter);
+
             emitterComponent.timeSinceLastSpawn += dt;
             int const particlesToSpawn =
                 static_cast<int>(emitterComponent.timeSinceLastSpawn * emitterComponent.particlesPerSecond);
@@ -101,9 +228,12 @@ void ParticleSystem::UpdateOneStep(const float& dt) const
                 emitterComponent.timeSinceLastSpawn -=
                     static_cast<float>(particlesToSpawn) / emitterComponent.particlesPerSecond;
 
+            // draw the spread of every particle spawned this step in one batch
+            m_spreadBuffer.resize(static_cast<size_t>(particlesToSpawn) * 2);
+            m_random.FillRange(m_spreadBuffer.data(), m_spreadBuffer.size(), -1.f, 1.f);
             for (int i = 0; i < particlesToSpawn; i++)
             {
-                AddParticle(emitter);
+                AddParticle(emitter, {m_spreadBuffer[i * 2], m_spreadBuffer[i * 2 + 1]});
             }
         }
         else
@@ -113,6 +243,82 @@ void ParticleSystem::UpdateOneStep(const float& dt) const
     }
 }
 
+void ParticleSystem::AdvanceStatelessEmitter(const entt::entity emitter, const float dt)
+{
+    const auto& emitterComponent = m_registry.get<EmitterComponent>(emitter);
+    auto& particleConfigComponent = m_registry.get<ParticleConfigComponent>(emitter);
+    if (particleConfigComponent.bakedCurves == nullptr)
+        BakeCurves(particleConfigComponent);
+
+    auto* stateless = m_registry.try_get<StatelessParticlesComponent>(emitter);
+    if (stateless == nullptr)
+    {
+        stateless = &m_registry.emplace<StatelessParticlesComponent>(emitter);
+        stateless->seed = m_random.NextUInt();
+    }
+
+    stateless->time += dt;
+    const float rate = emitterComponent.particlesPerSecond;
+    if (rate > 0.f)
+    {
+        const float interval = 1.f / rate;
+
+        // particles spawned before this point are already dead, so count them without creating them
+        const float oldestAlive = stateless->time - particleConfigComponent.lifeSpan;
+        if (stateless->nextSpawnTime < oldestAlive)
+        {
+            const auto skipped = static_cast<uint32_t>((oldestAlive - stateless->nextSpawnTime) * rate);
+            stateless->nextSpawnTime += static_cast<float>(skipped) * interval;
+            stateless->spawnCount += skipped;
+        }
+
+        while (stateless->nextSpawnTime <= stateless->time)
+        {
+            stateless->particles.push_back(
+                {stateless->nextSpawnTime, HashUInt(stateless->seed + stateless->spawnCount)});
+            stateless->spawnCount++;
+            stateless->nextSpawnTime += interval;
+        }
+    }
+    else
+    {
+        stateless->nextSpawnTime = stateless->time;
+    }
+
+    auto& particles = stateless->particles;
+    while (stateless->firstAlive < particles.size() &&
+           stateless->time - particles[stateless->firstAlive].spawnTime >= particleConfigComponent.lifeSpan)
+    {
+        stateless->firstAlive++;
+    }
+    // drop the dead ones once they make up half of the buffer, keeps the erase cost amortized
+    if (stateless->firstAlive * 2 > particles.size())
+    {
+        particles.erase(particles.begin(), particles.begin() + static_cast<std::ptrdiff_t>(stateless->firstAlive));
+        stateless->firstAlive = 0;
+    }
+
+    // keep the clock small so it doesn't lose precision on emitters that run for hours
+    constexpr float rebaseTime = 1000.f;
+    if (stateless->time > rebaseTime)
+    {
+        stateless->time -= rebaseTime;
+        stateless->nextSpawnTime -= rebaseTime;
+        for (auto& particle : particles)
+        {
+            particle.spawnTime -= rebaseTime;
+        }
+    }
+}
+
+void ParticleSystem::FastForward(const entt::entity emitter, const float seconds)
+{
+    auto& emitterComponent = m_registry.get<EmitterComponent>(emitter);
+    if (emitterComponent.endless == false)
+        emitterComponent.currentLife -= seconds;
+    AdvanceStatelessEmitter(emitter, seconds);
+}
+
 void ParticleSystem::UpdateAtFixedTS(const float& dt)
 {
     m_accumulator += dt;
@@ -126,6 +332,20 @@ void ParticleSystem::UpdateAtFixedTS(const float& dt)
     }
 }
 
+void ParticleSystem::BakeCurves(ParticleConfigComponent& particleConfig) const
+{
+    // the editor leaves the keys in the order the user placed them, baking needs them sorted
+    Curve<glm::vec4> colorGradient = particleConfig.colorGradient;
+    Curve<float> scaleCurve = particleConfig.scaleCurve;
+    colorGradient.SortKeys();
+    scaleCurve.SortKeys();
+
+    auto baked = std::make_shared<ParticleLifetimeCurves>();
+    baked->color.Bake(colorGradient);
+    baked->scale.Bake(scaleCurve);
+    particleConfig.bakedCurves = std::move(baked);
+}
+
 void ParticleSystem::ImGuiWindow()
 {
     if (!Engine.MainMenuBar().IsFlagOn(WindowsToDisplay::EmitterMenu))
@@ -191,12 +411,59 @@ void ParticleSystem::ImGuiWindow()
                     emitterComponent.currentLife = emitterComponent.lifeSpan;
             }
             ImGui::SliderFloat("Emit rate", &emitterComponent.particlesPerSecond, 0.f, 1000.f);
+            ImGui::Checkbox("Stateless", &emitterComponent.stateless);
+            ImGui::SameLine();
+            help_marker("Particles are computed from their age instead of simulated. They follow the emitter and don't collide.");
+            if (emitterComponent.stateless)
+            {
+                if (ImGui::Button("Pre-warm"))
+                    FastForward(emitter, particleConfigComponent.lifeSpan);
+                if (const auto* stateless = m_registry.try_get<StatelessParticlesComponent>(emitter))
+                {
+                    ImGui::SameLine();
+                    ImGui::Text("Particles: %d", static_cast<int>(stateless->particles.size() - stateless->firstAlive));
+                }
+            }
             ImGui::DragFloat("Gravity", &(particleConfigComponent.gravity));
-            ImGui::ColorEdit4("Start color", glm::value_ptr(particleConfigComponent.colorBegin));
-            ImGui::ColorEdit4("End color", glm::value_ptr(particleConfigComponent.colorEnd));
             ImGui::DragFloat("Speed", &(particleConfigComponent.speed));
             ImGui::DragFloat("Particle life", &(particleConfigComponent.lifeSpan));
 
+            const char* collisionModes[] = {"None", "Bounce", "Kill"};
+            int collision = static_cast<int>(particleConfigComponent.collision);
+            if (ImGui::Combo("Collision", &collision, collisionModes, IM_ARRAYSIZE(collisionModes)))
+                particleConfigComponent.collision = static_cast<ParticleCollision>(collision);
+            if (particleConfigComponent.collision != ParticleCollision::None && !emitterComponent.stateless)
+            {
+                ImGui::DragFloat("Ground height", &particleConfigComponent.groundHeight, 0.05f);
+                ImGui::Checkbox("Collide with physics bodies", &particleConfigComponent.collideWithBodies);
+                if (particleConfigComponent.collision == ParticleCollision::Bounce)
+                    ImGui::SliderFloat("Restitution", &particleConfigComponent.restitution, 0.f, 1.f);
+            }
+
+            const bool colorChanged = CurveEditor("Color over life", particleConfigComponent.colorGradient);
+            const bool scaleChanged = CurveEditor("Scale over life", particleConfigComponent.scaleCurve);
+            if (colorChanged || scaleChanged || particleConfigComponent.bakedCurves == nullptr)
+                BakeCurves(particleConfigComponent);
+
+            // preview of what the particles will actually sample
+            const auto& baked = *particleConfigComponent.bakedCurves;
+            ImDrawList* drawList = ImGui::GetWindowDrawList();
+            const ImVec2 start = ImGui::GetCursorScreenPos();
+            const float width = ImGui::GetContentRegionAvail().x;
+            const float sampleWidth = width / static_cast<float>(baked.color.samples.size());
+            for (size_t i = 0; i < baked.color.samples.size(); i++)
+            {
+                const glm::vec4& color = baked.color.samples[i];
+                const float x = start.x + sampleWidth * static_cast<float>(i);
+                drawList->AddRectFilled(
+                    {x, start.y}, {x + sampleWidth + 1.f, start.y + 12.f},
+                    ImGui::ColorConvertFloat4ToU32({color.r, color.g, color.b, color.a}));
+            }
+            ImGui::Dummy({width, 12.f});
+            ImGui::PlotLines(
+                "##scale preview", baked.scale.samples.data(), static_cast<int>(baked.scale.samples.size()), 0, nullptr, 0.f,
+                FLT_MAX, {width, 40.f});
+
         }
         if (ImGui::CollapsingHeader("Transform", ImGuiTreeNodeFlags_DefaultOpen))
         {
@@ -223,6 +490,19 @@ void ParticleSystem::ImGuiWindow()
 
 void ParticleSystem::Update(const float& dt)
 {
+    // asks PhysicsSystem2D to keep publishing its snapshot while an emitter collides with the bodies, every frame and
+    // not every step, so a frame without a fixed step does not make it drop the snapshot
+    const auto configView = m_registry.view<ParticleConfigComponent>();
+    const bool collideWithBodies = std::any_of(
+        configView.begin(), configView.end(),
+        [&configView](const entt::entity emitter)
+        {
+            const auto& config = configView.get<ParticleConfigComponent>(emitter);
+            return config.collision != ParticleCollision::None && config.collideWithBodies;
+        });
+    if (collideWithBodies)
+        m_registry.ctx().emplace<PhysicsGridSnapshotRequest2D>().requested = true;
+
     if (m_fixedTimeStep == false)
         UpdateOneStep(dt);
     else
@@ -231,8 +511,46 @@ void ParticleSystem::Update(const float& dt)
     ImGuiWindow();
 }
 
+void ParticleSystem::RenderStatelessParticles() const
+{
+    const auto view = m_registry.view<StatelessParticlesComponent, ParticleConfigComponent, TransformComponent>();
+    for (auto [emitter, stateless, particleConfig, emitterTransform] : view.each())
+    {
+        if (particleConfig.bakedCurves == nullptr)
+            continue;
+        const auto& curves = *particleConfig.bakedCurves;
+
+        for (size_t i = stateless.firstAlive; i < stateless.particles.size(); i++)
+        {
+            const auto& particle = stateless.particles[i];
+            const float age = stateless.time - particle.spawnTime;
+
+            // same spawn direction as AddParticle, but drawn from the seed
+            const uint32_t spreadX = HashUInt(particle.seed);
+            const uint32_t spreadZ = HashUInt(spreadX);
+            const glm::vec3 spread(HashToSignedFloat(spreadX), 0.f, HashToSignedFloat(spreadZ));
+            const glm::vec3 dir = glm::normalize(emitterTransform.rotation * glm::normalize(particleConfig.dir + spread));
+
+            // closed form of the update: dir.y loses gravity * dt every step and pos moves by dir * speed * dt
+            glm::vec3 pos = emitterTransform.pos + dir * particleConfig.speed * age;
+            pos.y -= 0.5f * particleConfig.gravity * particleConfig.speed * age * age;
+
+            const float normalizedAge = age / particleConfig.lifeSpan;
+            glm::mat4 transform = glm::translate(glm::mat4(1.f), pos);
+            transform = glm::scale(transform, emitterTransform.scale * curves.scale.Sample(normalizedAge));
+            const glm::vec4& color = curves.color.Sample(normalizedAge);
+
+            xsr::render_mesh(
+                value_ptr(transform), m_mesh.mesh->handle, m_mesh.texture->handle, value_ptr(m_mesh.mulColor),
+                value_ptr(color));
+        }
+    }
+}
+
 void ParticleSystem::Render() const
 {
+    RenderStatelessParticles();
+
     const auto renderView = m_registry.view<TransformComponent, MeshComponent, EmptyParticleComponent>();
     for (auto [entity, transformComponent, meshComponent] : renderView.each())
     {
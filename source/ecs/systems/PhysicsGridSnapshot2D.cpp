@@ -0,0 +1,108 @@
+#include "ecs/systems/PhysicsGridSnapshot2D.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <entt/entity/registry.hpp>
+#include <glm/common.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include "ecs/components/PhysicsBody2DComponent.h"
+#include "ecs/components/TransformComponent.h"
+
+namespace
+{
+// keeps the grid small when a few bodies are very far apart
+constexpr int MAX_CELLS_PER_AXIS = 128;
+} // namespace
+
+void bee::PhysicsGridSnapshot2D::Rebuild(entt::registry& registry)
+{
+    m_bodies.clear();
+
+    glm::vec2 min(FLT_MAX);
+    glm::vec2 max(-FLT_MAX);
+    float maxRadius = 0.f;
+    const auto view = registry.view<PhysicsBody2DComponent, TransformComponent>();
+    for (const auto [entity, body, transformComponent] : view.each())
+    {
+        m_bodies.push_back(
+            {body.position, body.scale, transformComponent.pos.y - transformComponent.scale.y,
+             transformComponent.pos.y + transformComponent.scale.y});
+        min = glm::min(min, body.position - body.scale);
+        max = glm::max(max, body.position + body.scale);
+        maxRadius = std::max(maxRadius, body.scale);
+    }
+
+    if (m_bodies.empty())
+    {
+        m_width = 0;
+        m_height = 0;
+        m_cellStart.clear();
+        m_cellBodies.clear();
+        return;
+    }
+
+    // cells as big as the largest disk, so a disk never covers more than four of them
+    const glm::vec2 extent = max - min;
+    float cellSize = std::max(maxRadius * 2.f, 1.f);
+    cellSize = std::max(cellSize, std::max(extent.x, extent.y) / static_cast<float>(MAX_CELLS_PER_AXIS - 1));
+    m_origin = min;
+    m_inverseCellSize = 1.f / cellSize;
+    m_width = static_cast<int>(extent.x * m_inverseCellSize) + 1;
+    m_height = static_cast<int>(extent.y * m_inverseCellSize) + 1;
+
+    const auto forEachCoveredCell = [this](const Body& body, auto&& function)
+    {
+        const glm::ivec2 first = glm::ivec2((body.position - body.radius - m_origin) * m_inverseCellSize);
+        const glm::ivec2 last = glm::ivec2((body.position + body.radius - m_origin) * m_inverseCellSize);
+        for (int y = std::max(first.y, 0); y <= std::min(last.y, m_height - 1); y++)
+        {
+            for (int x = std::max(first.x, 0); x <= std::min(last.x, m_width - 1); x++)
+            {
+                function(y * m_width + x);
+            }
+        }
+    };
+
+    // count the bodies per cell, turn the counts into offsets, then fill the cells back to front
+    m_cellStart.assign(static_cast<size_t>(m_width) * m_height + 1, 0);
+    for (const Body& body : m_bodies)
+    {
+        forEachCoveredCell(body, [this](const int cell) { m_cellStart[cell + 1]++; });
+    }
+    for (size_t i = 1; i < m_cellStart.size(); i++)
+    {
+        m_cellStart[i] += m_cellStart[i - 1];
+    }
+
+    m_cellBodies.resize(m_cellStart.back());
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_bodies.size()); i++)
+    {
+        forEachCoveredCell(m_bodies[i], [this, i](const int cell) { m_cellBodies[--m_cellStart[cell + 1]] = i; });
+    }
+    // filling walked the end of every cell back to its start, but stored one slot to the right, so shift them into place
+    std::rotate(m_cellStart.begin(), m_cellStart.begin() + 1, m_cellStart.end());
+    m_cellStart.back() = static_cast<uint32_t>(m_cellBodies.size());
+}
+
+const bee::PhysicsGridSnapshot2D::Body* bee::PhysicsGridSnapshot2D::FindBody(const glm::vec3& point) const
+{
+    const glm::vec2 point2D(point.x, point.z);
+    const glm::vec2 local = (point2D - m_origin) * m_inverseCellSize;
+    if (local.x < 0.f || local.y < 0.f)
+        return nullptr;
+    const int x = static_cast<int>(local.x);
+    const int y = static_cast<int>(local.y);
+    if (x >= m_width || y >= m_height)
+        return nullptr;
+
+    const int cell = y * m_width + x;
+    for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; i++)
+    {
+        const Body& body = m_bodies[m_cellBodies[i]];
+        if (point.y >= body.bottom && point.y <= body.top &&
+            glm::length2(point2D - body.position) < body.radius * body.radius)
+            return &body;
+    }
+    return nullptr;
+}
@@ -3,23 +3,34 @@
 #include <glm/vec2.hpp>
 #include <glm/gtx/norm.hpp>
 
-#include "ecs/components/AbilityComponent.h"
 #include "ecs/components/PhysicsBody2DComponent.h"
 #include "ecs/components/TransformComponent.h"
+#include "ecs/systems/PhysicsGridSnapshot2D.h"
+#include "ecs/WorldContext.h"
 
 #ifdef _DEBUG
 #include "core/engine.hpp"
 #include "rendering/debug_render.hpp"
 #endif
 
+namespace
+{
+bool IsAbilityLayer(const bee::CollisionLayer2D layer)
+{
+    return layer == bee::CollisionLayer2D::Projectile || layer == bee::CollisionLayer2D::AreaOfEffect;
+}
+} // namespace
 
 bee::PhysicsSystem2D::PhysicsSystem2D(entt::registry& registry)
-    : BaseSystem(registry) {}
+    : BaseSystem(registry), m_headless(registry.ctx().get<WorldContext>().headless) {}
 
 void bee::PhysicsSystem2D::Update(const float& dt)
 {
     UpdateTransforms(dt);
     CheckAndRegisterCollisions();
+    if (m_headless)
+        return; // nothing reads the snapshot or sees the debug drawing
+    PublishSnapshot();
     DebugDrawing();
 }
 
@@ -61,33 +72,76 @@ void bee::PhysicsSystem2D::UpdateTransforms(const float dt)
 }
 void bee::PhysicsSystem2D::CheckAndRegisterCollisions()
 {
+    auto& events = m_registry.ctx().emplace<CollisionEvents2D>();
+    events.abilityHits.clear();
+
+    m_abilityBodies.clear();
+    m_otherBodies.clear();
     auto view = m_registry.view<PhysicsBody2DComponent>();
-    for (auto [entity1, body1] : view.each())
+    for (auto [entity, body] : view.each())
+    {
+        if (IsAbilityLayer(body.layer))
+            m_abilityBodies.emplace_back(entity, &body);
+        else
+            m_otherBodies.emplace_back(entity, &body);
+    }
+
+    // abilities never collide with each other, so those pairs are never looked at
+    // and the cost grows with the number of abilities times the few other bodies
+    for (size_t i = 0; i < m_otherBodies.size(); i++)
+    {
+        for (size_t j = i + 1; j < m_otherBodies.size(); j++)
+        {
+            auto& [entity1, body1] = m_otherBodies[i];
+            auto& [entity2, body2] = m_otherBodies[j];
+            CheckPair(entity1, *body1, entity2, *body2, events);
+        }
+    }
+    for (auto& [abilityEntity, abilityBody] : m_abilityBodies)
     {
-        for (auto [entity2, body2] : view.each())
+        for (auto& [otherEntity, otherBody] : m_otherBodies)
         {
-            // same entity or entities that have already been checked
-            if (entity1 == entity2 || entity1 > entity2)
-                continue;
-
-            bool checkAndRegisterCol = true;
-            if (m_registry.try_get<AbilityComponent>(entity2))
-            {
-                if (m_registry.try_get<AbilityComponent>(entity1))
-                {
-                    checkAndRegisterCol = false;
-                }
-            }
-
-            if (checkAndRegisterCol)
-            {
-                CollisionData collision;
-                CheckAndRegisterCollision(entity1, body1, entity2, body2, collision);
-            }
+            CheckPair(abilityEntity, *abilityBody, otherEntity, *otherBody, events);
         }
     }
 }
 
+void bee::PhysicsSystem2D::CheckPair(
+    const entt::entity& entity1, PhysicsBody2DComponent& body1, const entt::entity& entity2, PhysicsBody2DComponent& body2,
+    CollisionEvents2D& events)
+{
+    // keep the order the pairs had when every body was checked against every body with a higher id
+    const bool swap = entity1 > entity2;
+    CollisionData collision;
+    const bool collided = swap ? CheckAndRegisterCollision(entity2, body2, entity1, body1, collision)
+                               : CheckAndRegisterCollision(entity1, body1, entity2, body2, collision);
+    if (!collided)
+        return;
+
+    // the normal in the collision points away from the second body
+    const glm::vec2 normalAwayFromBody2 = swap ? -collision.normal : collision.normal;
+    if (IsAbilityLayer(body1.layer) && body2.layer == CollisionLayer2D::Player)
+    {
+        events.abilityHits.push_back({entity1, entity2, normalAwayFromBody2, collision.contactPoint});
+    }
+}
+
+void bee::PhysicsSystem2D::PublishSnapshot()
+{
+    // read by systems that only need a coarse picture of the world, like particle collisions, and only built while one
+    // of them asks for it
+    auto* request = m_registry.ctx().find<PhysicsGridSnapshotRequest2D>();
+    if (request == nullptr || !request->requested)
+    {
+        // an old snapshot would be out of date by the time it is requested again
+        m_registry.ctx().erase<PhysicsGridSnapshot2D>();
+        return;
+    }
+
+    request->requested = false;
+    m_registry.ctx().emplace<PhysicsGridSnapshot2D>().Rebuild(m_registry);
+}
+
 void bee::PhysicsSystem2D::DebugDrawing()
 {
 #ifdef _DEBUG
@@ -1,39 +1,565 @@
 #include "ecs/systems/ScriptSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <utility>
 #include "ecs/components/ScriptComponent.h"
+#include "ecs/components/ScriptInstanceComponent.h"
+#include "ecs/WorldContext.h"
 #include "scripting/components_lua.h"
 #include "scripting/EntityLua.h"
 #include "tools/log.hpp"
 #include "scripting/glm_lua.h"
 #include "scripting/input_lua.h"
 
+namespace
+{
+bool LogIfFailed(const sol::protected_function_result& result)
+{
+    if (result.valid())
+        return false;
+
+    const sol::error error = result;
+    bee::Log::Error(error.what());
+    return true;
+}
+
+// the two modes read a different number of parameters, zeros keep Lua's defaults
+void SetCollectorMode(lua_State* lua, const bool generational)
+{
+    if (generational)
+        lua_gc(lua, LUA_GCGEN, 0, 0);
+    else
+        lua_gc(lua, LUA_GCINC, 0, 0, 0);
+}
+} // namespace
+
 bee::ScriptSystem::ScriptSystem(entt::registry& registry) : BaseSystem(registry)
 {
-    m_lua.open_libraries(sol::lib::base);
-    glm_lua::bind(m_lua);
-    entity_lua::bind(m_lua);
-    components_lua::bind(m_lua);
-    input_lua::bind(m_lua);
+    Bind(m_main, nullptr);
+
+    registry.on_construct<ScriptComponent>().connect<&ScriptSystem::OnScriptComponentConstruct>(this);
+    registry.on_destroy<ScriptComponent>().connect<&ScriptSystem::OnScriptComponentDestroy>(this);
+    registry.on_destroy<ScriptInstanceComponent>().connect<&ScriptSystem::OnScriptInstanceComponentDestroy>(this);
+}
+
+bee::ScriptSystem::~ScriptSystem()
+{
+    m_registry.on_construct<ScriptComponent>().disconnect(this);
+    m_registry.on_destroy<ScriptComponent>().disconnect(this);
+    m_registry.on_destroy<ScriptInstanceComponent>().disconnect(this);
+    StopWorkers();
+    m_registry.clear<ScriptInstanceComponent>();
+}
+
+void bee::ScriptSystem::Bind(ScriptState& state, StagedComponents* staged)
+{
+    state.lua.open_libraries(sol::lib::base);
+    glm_lua::bind(state.lua);
+    if (staged != nullptr)
+        entity_lua::bind(state.lua, std::as_const(m_registry), *staged);
+    else
+        entity_lua::bind(state.lua, m_registry);
+    components_lua::bind(state.lua);
+
+    // a view goes over the registry itself, so it is not given to the states that run in parallel
+    if (staged == nullptr)
+        components_lua::bind_view(state.lua, m_registry);
+    input_lua::bind(state.lua, m_registry.ctx().get<WorldContext>().input);
+
+    // the collector only runs in CollectGarbage
+    lua_State* lua = state.lua.lua_state();
+    SetCollectorMode(lua, m_generationalGarbageCollection);
+    lua_gc(lua, LUA_GCSTOP);
+    state.collectedBytes = state.allocator.GetStats().bytesInUse;
 }
 
 void bee::ScriptSystem::Update(const float& dt)
 {
-    const auto view = m_registry.view<ScriptComponent>();
-    for (auto [entity, scriptComponent] : view.each())
+    // only the scripts that changed on disk are compiled again
+    for (const auto& path : m_watcher.Poll(dt))
+    {
+        ReloadScript(path);
+    }
+
+    // before the scripts run, so what they start this frame waits from this frame's time
+    m_scheduler.Update(dt);
+
+    const auto view = m_registry.view<ScriptComponent, ScriptInstanceComponent>();
+    for (auto [entity, scriptComponent, instanceComponent] : view.each())
     {
-        for (auto& script : scriptComponent.scripts)
+        // scripts are usually added to the component after it was emplaced
+        if (instanceComponent.instances.size() != scriptComponent.scripts.size())
         {
-            auto result = m_lua.script_file(script, sol::script_pass_on_error);
-            if (!result.valid())
-            {
-                const sol::error error = result;
-                Log::Error(error.what());
-            }
+            CreateInstances(entity, scriptComponent, instanceComponent);
+        }
+
+        for (const auto& instance : instanceComponent.instances)
+        {
+            if (!instance.object.valid())
+                continue;
+
+            if (instance.worker >= 0)
+                m_workers[instance.worker]->jobs.push_back(&instance);
             else
+                UpdateInstance(m_main, instance, dt);
+        }
+    }
+
+    UpdateBatches(m_main, dt);
+    UpdateWorkers(dt);
+
+    // the workers collected their garbage on their own threads
+    m_garbageCollectionSeconds = CollectGarbage(m_main);
+
+    m_main.profiler.EndFrame();
+    m_main.profiler.ImGuiWindow(GetMemoryStats(), m_garbageCollectionSeconds);
+}
+
+void bee::ScriptSystem::SetGenerationalGarbageCollection(const bool generational)
+{
+    m_generationalGarbageCollection = generational;
+    SetCollectorMode(m_main.lua.lua_state(), generational);
+    m_main.collecting = false;
+
+    // the workers are idle between two updates
+    for (auto& worker : m_workers)
+    {
+        SetCollectorMode(worker->state.lua.lua_state(), generational);
+        worker->state.collecting = false;
+    }
+}
+
+bee::LuaAllocator::Stats bee::ScriptSystem::GetMemoryStats() const
+{
+    LuaAllocator::Stats stats = m_main.allocator.GetStats();
+    for (const auto& worker : m_workers)
+    {
+        stats += worker->state.allocator.GetStats();
+    }
+    return stats;
+}
+
+float bee::ScriptSystem::CollectGarbage(ScriptState& state) const
+{
+    lua_State* lua = state.lua.lua_state();
+    const auto& stats = state.allocator.GetStats();
+    const auto start = std::chrono::steady_clock::now();
+
+    if (m_generationalGarbageCollection)
+    {
+        if (stats.bytesInUse * 100 < state.collectedBytes * GENERATIONAL_GROWTH_PERCENT)
+            return 0.f;
+
+        lua_gc(lua, LUA_GCSTEP, 0);
+        state.collectedBytes = stats.bytesInUse;
+    }
+    else
+    {
+        if (!state.collecting && stats.bytesInUse * 100 < state.collectedBytes * INCREMENTAL_PAUSE_PERCENT)
+            return 0.f;
+
+        if (stats.bytesInUse * 100 >= state.collectedBytes * RUNAWAY_PERCENT)
+        {
+            // the steps within the budget do not keep up with the garbage, a full collection frees all of it at once
+            lua_gc(lua, LUA_GCCOLLECT);
+            state.collecting = false;
+            state.collectedBytes = stats.bytesInUse;
+            return std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        if (!state.collecting)
+        {
+            state.collecting = true;
+            state.cycleStartAllocatedBytes = stats.allocatedBytes;
+        }
+
+        const std::chrono::duration<float> budget(m_garbageCollectionBudget);
+        do
+        {
+            // true once the step finished the cycle
+            if (lua_gc(lua, LUA_GCSTEP, 0) != 0)
             {
-                sol::table type = result;
-                sol::table object = type["new"]();
-                object["update"](object, EntityLua(entity), dt);
+                // objects made during the cycle are kept until the next one, whether they are garbage or not
+                const uint64_t allocatedDuringCycle = stats.allocatedBytes - state.cycleStartAllocatedBytes;
+                state.collecting = false;
+                state.collectedBytes = stats.bytesInUse - static_cast<size_t>(
+                    std::min<uint64_t>(allocatedDuringCycle, stats.bytesInUse / 2));
+                break;
             }
+        } while (std::chrono::steady_clock::now() - start < budget);
+    }
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+}
+
+void bee::ScriptSystem::UpdateInstance(
+    ScriptState& state, const ScriptInstanceComponent::Instance& instance, const float dt)
+{
+    auto* script = Load(state, instance.script);
+    if (script == nullptr)
+        return;
+
+    if (script->updateAll.valid())
+    {
+        // Lua arrays start at 1
+        script->batchSize++;
+        script->batchInstances.raw_set(script->batchSize, instance.object);
+        script->batchEntities.raw_set(script->batchSize, instance.entity);
+    }
+    else
+    {
+        LuaProfiler::Scope profilerScope(state.profiler, instance.script, script->path);
+        LogIfFailed(script->update(instance.object, instance.entity, dt));
+    }
+}
+
+void bee::ScriptSystem::UpdateBatches(ScriptState& state, const float dt)
+{
+    for (ScriptID id = 0; id < static_cast<ScriptID>(state.scripts.size()); id++)
+    {
+        auto& script = state.scripts[id];
+        if (!script.valid || !script.updateAll.valid())
+            continue;
+
+        // clear what is left from a bigger batch, so the length of the arrays is the batch size
+        for (int index = script.batchSize + 1; index <= script.previousBatchSize; index++)
+        {
+            script.batchInstances.raw_set(index, sol::lua_nil);
+            script.batchEntities.raw_set(index, sol::lua_nil);
+        }
+        script.previousBatchSize = script.batchSize;
+        script.batchSize = 0;
+
+        if (script.previousBatchSize > 0)
+        {
+            LuaProfiler::Scope profilerScope(state.profiler, id, script.path);
+            LogIfFailed(script.updateAll(script.batchInstances, script.batchEntities, dt));
         }
     }
 }
+
+bee::ScriptID bee::ScriptSystem::Intern(const std::string& path)
+{
+    if (const auto it = m_ids.find(path); it != m_ids.end())
+    {
+        return it->second;
+    }
+
+    const auto id = static_cast<ScriptID>(m_main.scripts.size());
+    m_ids.emplace(path, id);
+    m_main.scripts.emplace_back().path = path;
+    return id;
+}
+
+void bee::ScriptSystem::ReloadScript(const std::string& path)
+{
+    const auto it = m_ids.find(path);
+    if (it == m_ids.end() || !m_main.scripts[it->second].loaded)
+        return; // not used yet, it is loaded from the file anyway
+
+    const ScriptID id = it->second;
+    if (!ReloadIn(m_main, id))
+    {
+        Log::Warn("Script {} keeps running its previous version", path);
+        return;
+    }
+
+    // the workers are idle between two updates
+    for (auto& worker : m_workers)
+    {
+        if (id < worker->state.scripts.size() && worker->state.scripts[id].loaded)
+            ReloadIn(worker->state, id);
+    }
+
+    if (m_main.scripts[id].valid)
+    {
+        SwapInstances(id);
+    }
+    Log::Info("Reloaded script {}", path);
+}
+
+bool bee::ScriptSystem::ReloadIn(ScriptState& state, const ScriptID id)
+{
+    CachedScript reloaded;
+    reloaded.path = m_main.scripts[id].path;
+    reloaded.loaded = true;
+    reloaded.valid = Compile(state.lua, reloaded);
+    if (!reloaded.valid && state.scripts[id].valid)
+        return false;
+
+    state.scripts[id] = std::move(reloaded);
+    return true;
+}
+
+void bee::ScriptSystem::ReloadAllScripts()
+{
+    for (const auto& [path, id] : m_ids)
+    {
+        ReloadScript(path);
+    }
+}
+
+bee::ScriptSystem::CachedScript* bee::ScriptSystem::Load(ScriptState& state, const ScriptID id)
+{
+    if (id >= state.scripts.size())
+        state.scripts.resize(id + 1);
+
+    auto& script = state.scripts[id];
+    if (!script.loaded)
+    {
+        script.path = m_main.scripts[id].path;
+        script.loaded = true;
+        script.valid = Compile(state.lua, script);
+    }
+    return script.valid ? &script : nullptr;
+}
+
+bool bee::ScriptSystem::Compile(sol::state& lua, CachedScript& script)
+{
+    const auto result = lua.safe_script_file(script.path, sol::script_pass_on_error);
+    if (LogIfFailed(result))
+        return false;
+    if (result.get_type() != sol::type::table)
+    {
+        Log::Error("Script {} does not return its type", script.path);
+        return false;
+    }
+
+    script.type = result;
+    script.create = script.type["new"];
+    script.update = script.type["update"];
+    script.updateAll = script.type["update_all"];
+    script.init = script.type["init"];
+    script.destroy = script.type["destroy"];
+    script.parallelSafe = script.type["parallel_safe"].get_or(false);
+    if (!script.create.valid() || !script.update.valid() && !script.updateAll.valid())
+    {
+        Log::Error("Script {} has no new or update function", script.path);
+        return false;
+    }
+
+    if (script.updateAll.valid())
+    {
+        script.batchInstances = lua.create_table();
+        script.batchEntities = lua.create_table();
+    }
+    return true;
+}
+
+void bee::ScriptSystem::SwapInstances(const ScriptID id)
+{
+    const auto view = m_registry.view<ScriptInstanceComponent>();
+    for (auto [entity, instanceComponent] : view.each())
+    {
+        for (auto& instance : instanceComponent.instances)
+        {
+            if (instance.script != id)
+                continue;
+
+            // the instance keeps its fields and finds the new functions through its metatable, it stays in its state
+            // until it is made again, even if the script changed whether it is parallel safe
+            const auto& script = StateOf(instance).scripts[id];
+            if (instance.object.valid() && script.valid)
+                instance.object[sol::metatable_key] = script.type;
+            else if (!instance.object.valid())
+                CreateInstance(entity, instance);
+        }
+    }
+}
+
+void bee::ScriptSystem::CreateInstances(
+    const entt::entity entity, const ScriptComponent& scriptComponent, ScriptInstanceComponent& instanceComponent)
+{
+    DestroyInstances(instanceComponent);
+    for (const auto& path : scriptComponent.scripts)
+    {
+        auto& instance = instanceComponent.instances.emplace_back();
+        instance.script = Intern(path);
+        CreateInstance(entity, instance);
+    }
+}
+
+void bee::ScriptSystem::CreateInstance(const entt::entity entity, ScriptInstanceComponent::Instance& instance)
+{
+    // the main state loads every script, it tells where the instances of the script run
+    const auto* mainScript = Load(m_main, instance.script);
+    const bool parallel = mainScript != nullptr && mainScript->parallelSafe;
+    if (parallel && m_workers.empty())
+    {
+        StartWorkers();
+    }
+    instance.worker = parallel ? WorkerOf(entity) : -1;
+
+    auto& state = StateOf(instance);
+    instance.entity = sol::make_object(state.lua, EntityLua(entity));
+    const auto* script = Load(state, instance.script);
+    if (script == nullptr)
+        return;
+
+    const auto object = script->create(instance.entity);
+    if (LogIfFailed(object))
+        return;
+    if (object.get_type() != sol::type::table)
+    {
+        Log::Error("The new function of script {} does not return the instance", script->path);
+        return;
+    }
+
+    instance.object = object;
+    if (script->init.valid())
+    {
+        // outside of the parallel run, so what init changes is written back right away
+        if (instance.worker >= 0)
+            m_workers[instance.worker]->staged.Refresh(m_registry);
+        LogIfFailed(script->init(instance.object, instance.entity));
+        if (instance.worker >= 0)
+            ApplyStaged(instance.worker);
+    }
+}
+
+void bee::ScriptSystem::DestroyInstances(ScriptInstanceComponent& instanceComponent)
+{
+    for (const auto& instance : instanceComponent.instances)
+    {
+        if (!instance.object.valid())
+            continue;
+
+        const auto* script = Load(StateOf(instance), instance.script);
+        if (script != nullptr && script->destroy.valid())
+        {
+            // like init, written back right away
+            if (instance.worker >= 0)
+                m_workers[instance.worker]->staged.Refresh(m_registry);
+            LogIfFailed(script->destroy(instance.object, instance.entity));
+            if (instance.worker >= 0)
+                ApplyStaged(instance.worker);
+        }
+    }
+    instanceComponent.instances.clear();
+}
+
+bee::ScriptSystem::ScriptState& bee::ScriptSystem::StateOf(const ScriptInstanceComponent::Instance& instance)
+{
+    return instance.worker >= 0 ? m_workers[instance.worker]->state : m_main;
+}
+
+int bee::ScriptSystem::WorkerOf(const entt::entity entity) const
+{
+    const auto chunk = static_cast<uint32_t>(entt::to_entity(entity)) / WORKER_CHUNK_SIZE;
+    return static_cast<int>(chunk % static_cast<uint32_t>(m_workers.size()));
+}
+
+void bee::ScriptSystem::StartWorkers()
+{
+    const unsigned workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned i = 0; i < workerCount; i++)
+    {
+        auto& worker = *m_workers.emplace_back(std::make_unique<Worker>());
+        Bind(worker.state, &worker.staged);
+    }
+
+    // started once every worker exists, the vector does not change while they run
+    for (size_t i = 1; i < m_workers.size(); i++)
+    {
+        m_workers[i]->thread = std::thread([this, &worker = *m_workers[i]] { WorkerLoop(worker); });
+    }
+}
+
+void bee::ScriptSystem::StopWorkers()
+{
+    {
+        std::lock_guard lock(m_workMutex);
+        m_stopWorkers = true;
+    }
+    m_workStarted.notify_all();
+    for (auto& worker : m_workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+}
+
+void bee::ScriptSystem::UpdateWorkers(const float dt)
+{
+    const bool hasJobs =
+        std::any_of(m_workers.begin(), m_workers.end(), [](const auto& worker) { return !worker->jobs.empty(); });
+    if (!hasJobs)
+        return;
+
+    {
+        std::lock_guard lock(m_workMutex);
+        m_workDt = dt;
+        m_busyWorkers = m_workers.size() - 1;
+        m_workFrame++;
+    }
+    m_workStarted.notify_all();
+
+    RunWorker(*m_workers.front(), dt);
+    {
+        std::unique_lock lock(m_workMutex);
+        m_workFinished.wait(lock, [this] { return m_busyWorkers == 0; });
+    }
+
+    // the sync point
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        ApplyStaged(static_cast<int>(i));
+    }
+}
+
+void bee::ScriptSystem::ApplyStaged(const int worker)
+{
+    // a worker writes back only the components of its own entities
+    m_workers[worker]->staged.Apply(
+        m_registry, [this, worker](const entt::entity entity) { return WorkerOf(entity) == worker; });
+}
+
+void bee::ScriptSystem::RunWorker(Worker& worker, const float dt)
+{
+    // the main state and the other systems changed the registry since the last run
+    worker.staged.Refresh(m_registry);
+    for (const auto* instance : worker.jobs)
+    {
+        UpdateInstance(worker.state, *instance, dt);
+    }
+    worker.jobs.clear();
+    UpdateBatches(worker.state, dt);
+    CollectGarbage(worker.state);
+}
+
+void bee::ScriptSystem::WorkerLoop(Worker& worker)
+{
+    uint64_t frame = 0;
+    while (true)
+    {
+        float dt = 0.f;
+        {
+            std::unique_lock lock(m_workMutex);
+            m_workStarted.wait(lock, [this, frame] { return m_stopWorkers || m_workFrame != frame; });
+            if (m_stopWorkers)
+                return;
+            frame = m_workFrame;
+            dt = m_workDt;
+        }
+
+        RunWorker(worker, dt);
+
+        std::lock_guard lock(m_workMutex);
+        if (--m_busyWorkers == 0)
+            m_workFinished.notify_one();
+    }
+}
+
+void bee::ScriptSystem::OnScriptComponentConstruct(entt::registry& registry, const entt::entity entity)
+{
+    registry.emplace_or_replace<ScriptInstanceComponent>(entity);
+}
+
+void bee::ScriptSystem::OnScriptComponentDestroy(entt::registry& registry, const entt::entity entity)
+{
+    registry.remove<ScriptInstanceComponent>(entity);
+}
+
+void bee::ScriptSystem::OnScriptInstanceComponentDestroy(entt::registry& registry, const entt::entity entity)
+{
+    DestroyInstances(registry.get<ScriptInstanceComponent>(entity));
+}
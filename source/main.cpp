@@ -1,11 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <imgui.h>
+#include <imgui_impl.h>
 
 #include "core/engine.hpp"
+#include "oop_particle_system/Emitter.h"
+#include "resource_managers/AbilityManager.h"
+#include "tools/CombatSimulator.h"
+#include "tools/Serializer.h"
+#include "tools/log.hpp"
 
 using namespace bee;
 
-int main()
+namespace
 {
+// bee --simulate [matches] [seed] [threads]
+// plays bot matches with the saved abilities without opening a window and prints how every ability did
+int Simulate(const int argc, char* argv[])
+{
+    CombatSimulationSettings settings;
+    if (argc > 2)
+        settings.matches = std::atoi(argv[2]);
+    if (argc > 3)
+        settings.seed = std::strtoull(argv[3], nullptr, 10);
+    if (argc > 4)
+        settings.threads = static_cast<unsigned>(std::atoi(argv[4]));
+
+    AbilityManager abilityManager;
+    if (!Serializer().DeserializeAbilities(abilityManager))
+    {
+        Log::Error("No serialized.cereal file to load the abilities from");
+        return 1;
+    }
+
+    CombatSimulator(abilityManager).Run(settings);
+    return 0;
+}
+
+// bee --benchmark-emitter [frames]
+// runs the OOP particle emitter at its defaults, 18,000 particles/s into the 40,000 pool, once it filled up, and
+// prints how long its update and render take per frame
+int BenchmarkEmitter(const int argc, char* argv[])
+{
+    const int frames = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 3000;
+    constexpr int warmUpFrames = 600; // the particles live 2 s, so they stop growing after 2 s at 60 fps
+    constexpr float dt = 1.f / 60.f;
+
+    // the engine is not shut down afterwards, that would save the scene
+    Engine.Initialize();
+    Emitter emitter(&Engine.SimpleRenderer());
+
+    using Clock = std::chrono::high_resolution_clock;
+    double updateMilliseconds = 0.0;
+    double renderMilliseconds = 0.0;
+    for (int frame = 0; frame < warmUpFrames + frames; frame++)
+    {
+        ImGui_Impl_NewFrame();
+        const auto start = Clock::now();
+        emitter.Update(dt);
+        const auto updated = Clock::now();
+        emitter.Render(&Engine.SimpleRenderer());
+        const auto rendered = Clock::now();
+        // without swapping the buffers, so vsync does not decide how long a frame takes
+        ImGui_Impl_RenderDrawData();
+
+        if (frame < warmUpFrames)
+            continue;
+        updateMilliseconds += std::chrono::duration<double, std::milli>(updated - start).count();
+        renderMilliseconds += std::chrono::duration<double, std::milli>(rendered - updated).count();
+    }
+
+    // the render time is what the CPU spends building and submitting the draws, the GPU may still be busy
+    printf(
+        "%d frames, update %.3f ms, render %.3f ms per frame\n", frames, updateMilliseconds / frames,
+        renderMilliseconds / frames);
+    return 0;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::strcmp(argv[1], "--simulate") == 0)
+    {
+        Log::Initialize();
+        return Simulate(argc, argv);
+    }
+
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark-emitter") == 0)
+    {
+        return BenchmarkEmitter(argc, argv);
+    }
+
     Engine.Initialize();
     Engine.Run();
     Engine.Shutdown();
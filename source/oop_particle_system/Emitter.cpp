@@ -2,6 +2,7 @@
 #include "rendering/simple_renderer.hpp"
 #include "oop_particle_system/Emitter.h"
 
+#include <chrono>
 #include <imgui.h>
 
 #include <glm/gtc/type_ptr.hpp>
@@ -54,53 +55,57 @@ Emitter::Emitter(bee::SimpleRenderer* simpleRenderer)
     cube->texture = std::make_shared<bee::SimpleTexture>("textures/white.png");
 }
 
-void Emitter::AddParticle()
+namespace
 {
-    if (m_activeParticles < m_maxParticles)
-    {
-        for (Particle& particle : m_particlePool)
-        {
-            if (!particle.active)
-            {
-                particle.active = true;
-                particle.pos = m_props.pos;
-                vec3 const randDir =
-                    normalize(m_props.dir + vec3(bee::RandomFloatBtwnMinus1and1(), 0.f, bee::RandomFloatBtwnMinus1and1()));
-                particle.velocity = randDir * m_props.speed;
-                particle.color = m_props.colorBegin;
-                particle.size = m_props.size;
-                particle.rotation = static_cast<float>(rand() % 90);
-                particle.lifeSpan = m_props.lifeSpan;
-
-                m_activeParticles++;
-
-                break;
-            }
-        }
-    }
+// exponential moving average, so the numbers in the window are readable
+void Smooth(float& average, const std::chrono::high_resolution_clock::time_point& start)
+{
+    const float milliseconds =
+        std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    average += (milliseconds - average) * 0.05f;
+}
+} // namespace
+
+void Emitter::AddParticle(const vec2& spread)
+{
+    if (m_activeParticles >= m_maxParticles)
+        return;
+
+    // the first slot after the live range is always free
+    Particle& particle = m_particlePool[m_activeParticles];
+    particle.pos = m_props.pos;
+    vec3 const randDir = normalize(m_props.dir + vec3(spread.x, 0.f, spread.y));
+    particle.velocity = randDir * m_props.speed;
+    particle.color = m_props.colorBegin;
+    particle.size = m_props.size;
+    particle.rotation = static_cast<float>(m_random.NextUInt(90));
+    particle.lifeSpan = m_props.lifeSpan;
+
+    m_activeParticles++;
 }
 
 void Emitter::UpdateOneStep(float const dt)
 {
-    for (Particle& particle : m_particlePool)
+    int i = 0;
+    while (i < m_activeParticles)
     {
-        if (particle.active)
+        Particle& particle = m_particlePool[i];
+        if (particle.lifeSpan >= 0)
+        {
+            if (m_props.hasGravity)
+                particle.velocity.y -= m_props.gravity * dt;
+            particle.pos += particle.velocity * dt;
+            float const deltaColor = particle.lifeSpan / m_props.lifeSpan;
+            particle.color = glm::lerp(m_props.colorEnd, m_props.colorBegin, deltaColor);
+            particle.size = glm::lerp(0.f, m_props.size, deltaColor);
+            particle.lifeSpan -= dt;
+            i++;
+        }
+        else
         {
-            if (particle.lifeSpan >= 0)
-            {
-                if (m_props.hasGravity)
-                    particle.velocity.y -= m_props.gravity * dt;
-                particle.pos += particle.velocity * dt;
-                float const deltaColor = particle.lifeSpan / m_props.lifeSpan;
-                particle.color = glm::lerp(m_props.colorEnd, m_props.colorBegin, deltaColor);
-                particle.size = glm::lerp(0.f, m_props.size, deltaColor);
-                particle.lifeSpan -= dt;
-            }
-            else
-            {
-                m_activeParticles--;
-                particle.active = false;
-            }
+            // swap and pop, the particle moved into this slot gets updated on the next iteration
+            m_activeParticles--;
+            particle = m_particlePool[m_activeParticles];
         }
     }
 
@@ -109,9 +114,11 @@ void Emitter::UpdateOneStep(float const dt)
     if (particlesToSpawn != 0)
         m_timeSinceLastSpawn -= static_cast<float>(particlesToSpawn) / m_props.particlesPerSecond;
 
+    m_spreadBuffer.resize(static_cast<size_t>(particlesToSpawn) * 2);
+    m_random.FillRange(m_spreadBuffer.data(), m_spreadBuffer.size(), -1.f, 1.f);
     for (int i = 0; i < particlesToSpawn; i++)
     {
-        AddParticle();
+        AddParticle({m_spreadBuffer[i * 2], m_spreadBuffer[i * 2 + 1]});
     }
 }
 
@@ -147,32 +154,36 @@ void Emitter::ImGuiWindow()
 
     ImGui::Text("Active particles: %d", (m_activeParticles));
     ImGui::Text("Max possible particles: %d", (m_maxParticles));
+    ImGui::Text("Update: %.3f ms", m_updateMilliseconds);
+    ImGui::Text("Render: %.3f ms", m_renderMilliseconds);
     ImGui::End();
 }
 
 void Emitter::Update(float const dt)
 {
+    const auto start = std::chrono::high_resolution_clock::now();
     if (!m_props.fixedTimeStep)
         UpdateOneStep(dt);
     else
         UpdateAtFixedTS(dt);
+    Smooth(m_updateMilliseconds, start);
 
     ImGuiWindow();
 }
 
 void Emitter::Render(bee::SimpleRenderer* simpleRenderer)
 {
-    for (Particle& particle : m_particlePool)
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < m_activeParticles; i++)
     {
-        if (particle.active)
-        {
-            mat4 transform = mat4(1.0f);
-            transform = glm::translate(transform, particle.pos);
-            transform = glm::scale(transform, vec3(0.035f) * particle.size);
-            if (m_props.randomRotations)
-                transform = glm::rotate(transform, glm::radians(particle.rotation), vec3(1.f, 1.f, 1.f));
-            simpleRenderer->RenderMesh(cube.get(), transform, vec4(particle.color.x, particle.color.y, particle.color.z, 1.f));
-        }
+        const Particle& particle = m_particlePool[i];
+        mat4 transform = mat4(1.0f);
+        transform = glm::translate(transform, particle.pos);
+        transform = glm::scale(transform, vec3(0.035f) * particle.size);
+        if (m_props.randomRotations)
+            transform = glm::rotate(transform, glm::radians(particle.rotation), vec3(1.f, 1.f, 1.f));
+        simpleRenderer->RenderMesh(cube.get(), transform, vec4(particle.color.x, particle.color.y, particle.color.z, 1.f));
     }
     simpleRenderer->Render();
+    Smooth(m_renderMilliseconds, start);
 }
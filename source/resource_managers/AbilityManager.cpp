@@ -2,25 +2,54 @@
 
 #include "tools/log.hpp"
 
-void bee::AbilityManager::Add(const std::string& name, const AbilitySettings& abilitySettings)
+bee::AbilityID bee::AbilityManager::Add(const std::string& name, const AbilitySettings& abilitySettings)
 {
-    m_abilities[name] = abilitySettings;
+    const AbilityID id = Intern(name);
+    m_settings[id] = abilitySettings;
+    m_plans[id] = CompileAbilityPlan(abilitySettings);
+    m_exists[id] = true;
+    return id;
 }
-    
-std::optional<bee::AbilitySettings> bee::AbilityManager::Get(const std::string& name)
+
+bee::AbilityID bee::AbilityManager::Intern(const std::string& name)
+{
+    if (const auto it = m_ids.find(name); it != m_ids.end())
+    {
+        return it->second;
+    }
+
+    const auto id = static_cast<AbilityID>(m_names.size());
+    m_ids.emplace(name, id);
+    m_names.push_back(name);
+    m_settings.emplace_back();
+    m_plans.emplace_back();
+    m_exists.push_back(false);
+    return id;
+}
+
+std::optional<bee::AbilityID> bee::AbilityManager::Find(const std::string& name) const
 {
-    if (const auto it = m_abilities.find(name); it != m_abilities.end())
+    if (const auto it = m_ids.find(name); it != m_ids.end() && m_exists[it->second])
     {
         return it->second;
     }
     return std::nullopt;
 }
 
+bool bee::AbilityManager::Has(const AbilityID id) const { return id < m_exists.size() && m_exists[id]; }
+
+const bee::AbilitySettings& bee::AbilityManager::Get(const AbilityID id) const { return m_settings[id]; }
+
+const bee::AbilityPlan& bee::AbilityManager::GetPlan(const AbilityID id) const { return m_plans[id]; }
+
+const std::string& bee::AbilityManager::GetName(const AbilityID id) const { return m_names[id]; }
+
 void bee::AbilityManager::Remove(const std::string& name)
 {
-    if (const auto it = m_abilities.find(name); it != m_abilities.end())
+    if (const auto id = Find(name))
     {
-        m_abilities.erase(it);
+        // the settings stay in the table so abilities that are still alive can finish
+        m_exists[id.value()] = false;
     }
     else
     {
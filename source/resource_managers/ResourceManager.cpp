@@ -19,39 +19,30 @@ void bee::ResourceManager::ImGuiWindow()
     ImGui::Begin("Resources");
     if (ImGui::CollapsingHeader("Abilities", ImGuiTreeNodeFlags_DefaultOpen))
     {
-        std::string abilityToDelete;
-        for (const auto& [name, abilitySettings] : m_abilityManager.m_abilities)
-        {
-            ImGui::Text("%s", name.c_str());
-            ImGui::SameLine();
-            ImGui::PushID(name.c_str());
-            if (ImGui::Button("Delete", ImVec2{50.f, 18.f}))
+        std::optional<AbilityID> abilityToDelete;
+        m_abilityManager.ForEach(
+            [&abilityToDelete](const AbilityID id, const std::string& name, const AbilitySettings&)
             {
-                abilityToDelete = name;
-            }
-            ImGui::PopID();
-        }
-        if (!abilityToDelete.empty())
+                ImGui::Text("%s", name.c_str());
+                ImGui::SameLine();
+                ImGui::PushID(static_cast<int>(id));
+                if (ImGui::Button("Delete", ImVec2{50.f, 18.f}))
+                {
+                    abilityToDelete = id;
+                }
+                ImGui::PopID();
+            });
+        if (abilityToDelete.has_value())
         {
             // remove from players
             auto view = Engine.ECS().Registry().view<AbilitiesOnPlayerComponent>();
             for (auto [player, abilitiesComponent] : view.each())
             {
-                for (auto it = abilitiesComponent.abilityNamesToInputsMap.begin();
-                     it != abilitiesComponent.abilityNamesToInputsMap.end();)
-                {
-                    if (it->first == abilityToDelete)
-                    {
-                        it = abilitiesComponent.abilityNamesToInputsMap.erase(it);
-                    }
-                    else
-                    {
-                        ++it;
-                    }
-                }
+                if (abilitiesComponent.abilityIDsToInputsMap.erase(abilityToDelete.value()) > 0)
+                    abilitiesComponent.bindingsRevision++;
             }
             // remove from manager
-            m_abilityManager.Remove(abilityToDelete);
+            m_abilityManager.Remove(m_abilityManager.GetName(abilityToDelete.value()));
         }
     }
     if (ImGui::CollapsingHeader("Models", ImGuiTreeNodeFlags_DefaultOpen))
@@ -0,0 +1,175 @@
+#include "scripting/LuaAllocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+// the size class of every size up to MAX_POOLED_SIZE in steps of 16, so finding it is one lookup
+constexpr size_t SIZE_STEP = 16;
+
+constexpr auto MakeSizeClassTable()
+{
+    std::array<uint8_t, bee::LuaAllocator::MAX_POOLED_SIZE / SIZE_STEP + 1> table = {};
+    size_t sizeClass = 0;
+    for (size_t step = 0; step < table.size(); step++)
+    {
+        while (bee::LuaAllocator::SIZE_CLASSES[sizeClass] < step * SIZE_STEP)
+            sizeClass++;
+        table[step] = static_cast<uint8_t>(sizeClass);
+    }
+    return table;
+}
+
+constexpr auto SIZE_CLASS_TABLE = MakeSizeClassTable();
+} // namespace
+
+bee::LuaAllocator::Stats& bee::LuaAllocator::Stats::operator+=(const Stats& other)
+{
+    bytesInUse += other.bytesInUse;
+    peakBytesInUse += other.peakBytesInUse;
+    reservedBytes += other.reservedBytes;
+    allocations += other.allocations;
+    allocatedBytes += other.allocatedBytes;
+    largeBlocks += other.largeBlocks;
+    for (size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; sizeClass++)
+        blocksInUse[sizeClass] += other.blocksInUse[sizeClass];
+    return *this;
+}
+
+bee::LuaAllocator::~LuaAllocator()
+{
+    for (auto* page : m_pages)
+    {
+        std::free(page);
+    }
+}
+
+void* bee::LuaAllocator::Allocate(void* userData, void* block, const size_t oldSize, const size_t newSize)
+{
+    auto* allocator = static_cast<LuaAllocator*>(userData);
+    if (newSize == 0)
+    {
+        if (block != nullptr)
+            allocator->FreeBlock(block, oldSize);
+        return nullptr;
+    }
+
+    // for a new block the old size is the type of the object, not a size
+    if (block == nullptr)
+        return allocator->AllocateBlock(newSize);
+    return allocator->ReallocateBlock(block, oldSize, newSize);
+}
+
+size_t bee::LuaAllocator::SizeClassOf(const size_t size)
+{
+    if (size > MAX_POOLED_SIZE)
+        return NOT_POOLED;
+    return SIZE_CLASS_TABLE[(size + SIZE_STEP - 1) / SIZE_STEP];
+}
+
+void* bee::LuaAllocator::AllocateBlock(const size_t size)
+{
+    const size_t sizeClass = SizeClassOf(size);
+    void* block = sizeClass != NOT_POOLED ? AllocatePooled(sizeClass) : std::malloc(size);
+    if (block == nullptr)
+        return nullptr;
+
+    const size_t blockSize = sizeClass != NOT_POOLED ? SIZE_CLASSES[sizeClass] : size;
+    m_stats.allocations++;
+    m_stats.allocatedBytes += blockSize;
+    m_stats.bytesInUse += blockSize;
+    if (sizeClass != NOT_POOLED)
+    {
+        m_stats.blocksInUse[sizeClass]++;
+    }
+    else
+    {
+        m_stats.reservedBytes += size;
+        m_stats.largeBlocks++;
+    }
+    m_stats.peakBytesInUse = std::max(m_stats.peakBytesInUse, m_stats.bytesInUse);
+    return block;
+}
+
+void bee::LuaAllocator::FreeBlock(void* block, const size_t size)
+{
+    const size_t sizeClass = SizeClassOf(size);
+    if (sizeClass == NOT_POOLED)
+    {
+        std::free(block);
+        m_stats.bytesInUse -= size;
+        m_stats.reservedBytes -= size;
+        m_stats.largeBlocks--;
+        return;
+    }
+
+    auto& pool = m_pools[sizeClass];
+    auto* node = static_cast<FreeListNode*>(block);
+    node->next = pool.freeBlocks;
+    pool.freeBlocks = node;
+    m_stats.bytesInUse -= SIZE_CLASSES[sizeClass];
+    m_stats.blocksInUse[sizeClass]--;
+}
+
+void* bee::LuaAllocator::ReallocateBlock(void* block, const size_t oldSize, const size_t newSize)
+{
+    const size_t oldClass = SizeClassOf(oldSize);
+    const size_t newClass = SizeClassOf(newSize);
+    if (oldClass != NOT_POOLED && oldClass == newClass)
+        return block;
+
+    if (oldClass == NOT_POOLED && newClass == NOT_POOLED)
+    {
+        void* resized = std::realloc(block, newSize);
+        if (resized == nullptr)
+            return nullptr;
+
+        if (newSize > oldSize)
+            m_stats.allocatedBytes += newSize - oldSize;
+        m_stats.bytesInUse = m_stats.bytesInUse - oldSize + newSize;
+        m_stats.reservedBytes = m_stats.reservedBytes - oldSize + newSize;
+        m_stats.peakBytesInUse = std::max(m_stats.peakBytesInUse, m_stats.bytesInUse);
+        return resized;
+    }
+
+    void* moved = AllocateBlock(newSize);
+    if (moved == nullptr)
+    {
+        // a block that shrinks can stay where it is, Lua only uses the front of it
+        return newSize <= oldSize ? block : nullptr;
+    }
+    std::memcpy(moved, block, std::min(oldSize, newSize));
+    FreeBlock(block, oldSize);
+    return moved;
+}
+
+void* bee::LuaAllocator::AllocatePooled(const size_t sizeClass)
+{
+    auto& pool = m_pools[sizeClass];
+    if (pool.freeBlocks != nullptr)
+    {
+        FreeListNode* node = pool.freeBlocks;
+        pool.freeBlocks = node->next;
+        return node;
+    }
+
+    const size_t blockSize = SIZE_CLASSES[sizeClass];
+    if (pool.pageCursor == nullptr || pool.pageCursor + blockSize > pool.pageEnd)
+    {
+        // malloc aligns the page like any block, the block sizes keep every block in it aligned the same way
+        auto* page = static_cast<std::byte*>(std::malloc(PAGE_SIZE));
+        if (page == nullptr)
+            return nullptr;
+
+        m_pages.push_back(page);
+        m_stats.reservedBytes += PAGE_SIZE;
+        pool.pageCursor = page;
+        pool.pageEnd = page + PAGE_SIZE;
+    }
+
+    void* block = pool.pageCursor;
+    pool.pageCursor += blockSize;
+    return block;
+}
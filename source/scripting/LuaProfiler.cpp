@@ -0,0 +1,295 @@
+#include "scripting/LuaProfiler.h"
+
+#include <algorithm>
+#include <imgui.h>
+
+#include "core/engine.hpp"
+#include "core/fileio.hpp"
+#include "tools/log.hpp"
+#include "tools/MainMenuBar.h"
+
+namespace
+{
+// the address is the key of the profiler in the registry of the Lua state, coroutines share the registry
+const char PROFILER_KEY = 0;
+} // namespace
+
+bee::LuaProfiler::LuaProfiler(lua_State* lua) : m_lua(lua) {}
+
+bee::LuaProfiler::~LuaProfiler() { SetEnabled(false); }
+
+bee::LuaProfiler::Scope::Scope(LuaProfiler& profiler, const ScriptID script, const std::string& path)
+{
+    if (!profiler.m_enabled)
+        return;
+
+    m_profiler = &profiler;
+    m_script = script;
+    m_path = &path;
+    m_allocatedBytes = profiler.m_allocatedBytes;
+    m_start = std::chrono::steady_clock::now();
+}
+
+bee::LuaProfiler::Scope::~Scope()
+{
+    // also skipped when the profiler was disabled during the call
+    if (m_profiler == nullptr || !m_profiler->m_enabled)
+        return;
+
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - m_start;
+    auto& scripts = m_profiler->m_scripts;
+    if (m_script >= scripts.size())
+        scripts.resize(m_script + 1);
+
+    auto& stats = scripts[m_script];
+    if (stats.path.empty())
+        stats.path = *m_path;
+    stats.calls++;
+    stats.seconds += duration.count();
+    stats.allocatedBytes += m_profiler->m_allocatedBytes - m_allocatedBytes;
+}
+
+void bee::LuaProfiler::SetEnabled(const bool enabled)
+{
+    if (enabled == m_enabled)
+        return;
+
+    m_enabled = enabled;
+    if (enabled)
+    {
+        lua_pushlightuserdata(m_lua, this);
+        lua_rawsetp(m_lua, LUA_REGISTRYINDEX, &PROFILER_KEY);
+        lua_sethook(m_lua, Hook, LUA_MASKCOUNT, SAMPLE_INTERVAL);
+
+        m_allocator = lua_getallocf(m_lua, &m_allocatorUserData);
+        lua_setallocf(m_lua, CountingAllocator, this);
+    }
+    else
+    {
+        lua_sethook(m_lua, nullptr, 0, 0);
+        lua_pushnil(m_lua);
+        lua_rawsetp(m_lua, LUA_REGISTRYINDEX, &PROFILER_KEY);
+
+        // blocks allocated through the counting allocator are freed by the same allocator underneath
+        lua_setallocf(m_lua, m_allocator, m_allocatorUserData);
+    }
+}
+
+void bee::LuaProfiler::Reset()
+{
+    m_frames = 0;
+    m_scripts.clear();
+    m_samples = 0;
+    m_stacks.clear();
+    m_functions.clear();
+}
+
+std::string bee::LuaProfiler::ExportFoldedStacks() const
+{
+    std::string folded;
+    for (const auto& [stack, samples] : m_stacks)
+    {
+        folded += stack;
+        folded += ' ';
+        folded += std::to_string(samples);
+        folded += '\n';
+    }
+    return folded;
+}
+
+void bee::LuaProfiler::Hook(lua_State* lua, lua_Debug*)
+{
+    lua_rawgetp(lua, LUA_REGISTRYINDEX, &PROFILER_KEY);
+    auto* profiler = static_cast<LuaProfiler*>(lua_touserdata(lua, -1));
+    lua_pop(lua, 1);
+    if (profiler != nullptr)
+        profiler->Sample(lua);
+}
+
+void* bee::LuaProfiler::CountingAllocator(void* userData, void* block, const size_t oldSize, const size_t newSize)
+{
+    auto* profiler = static_cast<LuaProfiler*>(userData);
+
+    // for a new block the old size is the type of the object, not a size
+    if (block == nullptr)
+        profiler->m_allocatedBytes += newSize;
+    else if (newSize > oldSize)
+        profiler->m_allocatedBytes += newSize - oldSize;
+
+    return profiler->m_allocator(profiler->m_allocatorUserData, block, oldSize, newSize);
+}
+
+void bee::LuaProfiler::Sample(lua_State* lua)
+{
+    // the frames from the running function up to the one C++ called
+    size_t depth = 0;
+    lua_Debug debug;
+    while (depth < MAX_SAMPLED_DEPTH && lua_getstack(lua, static_cast<int>(depth), &debug) != 0)
+    {
+        lua_getinfo(lua, "Sn", &debug);
+        if (depth == m_sampledFrames.size())
+            m_sampledFrames.emplace_back();
+
+        auto& frame = m_sampledFrames[depth++];
+        frame = debug.name != nullptr ? debug.name : "?";
+        if (debug.what[0] != 'C')
+        {
+            frame += " (";
+            frame += debug.short_src;
+            frame += ':';
+            frame += std::to_string(debug.linedefined);
+            frame += ')';
+        }
+        else
+        {
+            frame += " [C]";
+        }
+        // the folded format separates the frames with semicolons, chunks loaded from strings can have them
+        std::replace(frame.begin(), frame.end(), ';', ',');
+    }
+    if (depth == 0)
+        return;
+
+    std::string stack;
+    for (size_t frame = depth; frame-- > 0;)
+    {
+        stack += m_sampledFrames[frame];
+        if (frame > 0)
+            stack += ';';
+    }
+    m_stacks[stack]++;
+    m_samples++;
+
+    m_functions[m_sampledFrames[0]].selfSamples++;
+    for (size_t frame = 0; frame < depth; frame++)
+    {
+        // a recursive function counts once per sample
+        const auto end = m_sampledFrames.begin() + static_cast<std::ptrdiff_t>(frame);
+        if (std::find(m_sampledFrames.begin(), end, m_sampledFrames[frame]) == end)
+            m_functions[m_sampledFrames[frame]].totalSamples++;
+    }
+}
+
+void bee::LuaProfiler::ImGuiWindow(const LuaAllocator::Stats& memory, const float collectionSeconds)
+{
+    if (!Engine.MainMenuBar().IsFlagOn(WindowsToDisplay::ScriptProfiler))
+        return;
+
+    ImGui::SetNextWindowSize({500.f, 400.f}, ImGuiCond_Once);
+    ImGui::SetNextWindowPos({350.f, 650.f}, ImGuiCond_Once);
+    ImGui::Begin("Script Profiler");
+    bool enabled = m_enabled;
+    if (ImGui::Checkbox("Enabled", &enabled))
+    {
+        SetEnabled(enabled);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset"))
+    {
+        Reset();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export flame graph"))
+    {
+        const std::string path = "script_profile.folded";
+        if (Engine.FileIO().WriteTextFile(FileIO::Directory::Save, path, ExportFoldedStacks()))
+            Log::Info("Saved the sampled Lua stacks to {}", Engine.FileIO().GetPath(FileIO::Directory::Save, path));
+    }
+    ImGui::Text("Frames: %llu, samples: %llu", static_cast<unsigned long long>(m_frames),
+                static_cast<unsigned long long>(m_samples));
+
+    const double frames = static_cast<double>(std::max<uint64_t>(m_frames, 1));
+    double totalSeconds = 0.0;
+    for (const auto& stats : m_scripts)
+        totalSeconds += stats.seconds;
+
+    if (ImGui::CollapsingHeader("Memory"))
+    {
+        ImGui::Text("In use: %.1f KB, peak: %.1f KB", static_cast<double>(memory.bytesInUse) / 1024.0,
+                    static_cast<double>(memory.peakBytesInUse) / 1024.0);
+        ImGui::Text("Reserved: %.1f KB, large blocks: %zu", static_cast<double>(memory.reservedBytes) / 1024.0,
+                    memory.largeBlocks);
+        ImGui::Text("Allocations: %llu", static_cast<unsigned long long>(memory.allocations));
+        ImGui::Text("Garbage collection: %.3f ms", static_cast<double>(collectionSeconds) * 1000.0);
+        if (ImGui::BeginTable("Size classes", 2))
+        {
+            ImGui::TableSetupColumn("Block size");
+            ImGui::TableSetupColumn("Blocks in use");
+            ImGui::TableHeadersRow();
+            for (size_t sizeClass = 0; sizeClass < LuaAllocator::SIZE_CLASS_COUNT; sizeClass++)
+            {
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", LuaAllocator::SIZE_CLASSES[sizeClass]);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", memory.blocksInUse[sizeClass]);
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Scripts", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        if (ImGui::BeginTable("Scripts", 4))
+        {
+            ImGui::TableSetupColumn("Script");
+            ImGui::TableSetupColumn("Calls/frame");
+            ImGui::TableSetupColumn("Ms/frame");
+            ImGui::TableSetupColumn("KB/frame");
+            ImGui::TableHeadersRow();
+            for (const auto& stats : m_scripts)
+            {
+                if (stats.calls == 0)
+                    continue;
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", stats.path.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", static_cast<double>(stats.calls) / frames);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stats.seconds * 1000.0 / frames);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", static_cast<double>(stats.allocatedBytes) / 1024.0 / frames);
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Functions", ImGuiTreeNodeFlags_DefaultOpen) && m_samples > 0)
+    {
+        // the samples split the measured time of the scripts between the functions
+        const double msPerSample = totalSeconds * 1000.0 / static_cast<double>(m_samples) / frames;
+        std::vector<std::pair<const std::string*, const FunctionStats*>> functions;
+        functions.reserve(m_functions.size());
+        for (const auto& [name, stats] : m_functions)
+            functions.emplace_back(&name, &stats);
+        std::sort(
+            functions.begin(), functions.end(),
+            [](const auto& a, const auto& b) { return a.second->selfSamples > b.second->selfSamples; });
+
+        if (ImGui::BeginTable("Functions", 5))
+        {
+            ImGui::TableSetupColumn("Function");
+            ImGui::TableSetupColumn("Self %");
+            ImGui::TableSetupColumn("Total %");
+            ImGui::TableSetupColumn("Self ms/frame");
+            ImGui::TableSetupColumn("Total ms/frame");
+            ImGui::TableHeadersRow();
+            const double samples = static_cast<double>(m_samples);
+            for (const auto& [name, stats] : functions)
+            {
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", name->c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", static_cast<double>(stats->selfSamples) * 100.0 / samples);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", static_cast<double>(stats->totalSamples) * 100.0 / samples);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", static_cast<double>(stats->selfSamples) * msPerSample);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", static_cast<double>(stats->totalSamples) * msPerSample);
+            }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
@@ -0,0 +1,165 @@
+#include "scripting/ScriptScheduler.h"
+
+#include <algorithm>
+#include <entt/entity/registry.hpp>
+
+#include "ecs/components/ScriptInstanceComponent.h"
+#include "scripting/EntityLua.h"
+#include "tools/log.hpp"
+
+namespace
+{
+// the wait functions yield what the scheduler should wait for, the numbers match ScriptScheduler::Wait
+constexpr const char* WAIT_FUNCTIONS = R"(
+function wait_frames(frames) coroutine.yield(0, frames) end
+function wait(seconds) coroutine.yield(1, seconds) end
+function wait_until(predicate) coroutine.yield(2, predicate) end
+)";
+} // namespace
+
+bee::ScriptScheduler::ScriptScheduler(sol::state& lua, entt::registry& registry) : m_lua(lua), m_registry(registry)
+{
+    m_lua.open_libraries(sol::lib::coroutine);
+    m_lua.script(WAIT_FUNCTIONS);
+    m_lua.set_function(
+        "start",
+        [this](const EntityLua& entity, const sol::protected_function& function, const sol::variadic_args& args)
+        { Start(entity.m_entityID, function, args); });
+}
+
+void bee::ScriptScheduler::Update(const float dt)
+{
+    m_time += static_cast<double>(dt);
+    m_frame++;
+    m_waitingFrames.Advance(static_cast<double>(m_frame), [this](const Handle& handle) { Resume(handle); });
+    m_waitingSeconds.Advance(m_time, [this](const Handle& handle) { Resume(handle); });
+
+    // coroutines resumed here can start waiting again, so poll from a copy
+    m_polling.swap(m_waitingUntil);
+    for (auto& waiting : m_polling)
+    {
+        if (Find(waiting.handle) == nullptr)
+            continue;
+
+        const sol::protected_function_result result = waiting.predicate();
+        if (!result.valid())
+        {
+            const sol::error error = result;
+            Log::Error(error.what());
+            Free(waiting.handle, false);
+        }
+        else if (result.get<bool>())
+        {
+            Resume(waiting.handle);
+        }
+        else
+        {
+            m_waitingUntil.push_back(std::move(waiting));
+        }
+    }
+    m_polling.clear();
+}
+
+void bee::ScriptScheduler::Start(
+    const entt::entity entity, const sol::protected_function& function, const sol::variadic_args& args)
+{
+    Handle handle;
+    if (!m_freeCoroutines.empty())
+    {
+        handle.index = m_freeCoroutines.back();
+        m_freeCoroutines.pop_back();
+    }
+    else
+    {
+        handle.index = static_cast<uint32_t>(m_coroutines.size());
+        m_coroutines.emplace_back();
+    }
+
+    auto& coroutine = m_coroutines[handle.index];
+    handle.generation = coroutine.generation;
+    if (!coroutine.thread.valid())
+        coroutine.thread = sol::thread::create(m_lua.lua_state());
+    coroutine.function = sol::coroutine(coroutine.thread.thread_state(), function);
+    coroutine.entity = entity;
+
+    // runs right away up to the first wait
+    Resume(handle, args);
+}
+
+template <typename... Args>
+void bee::ScriptScheduler::Resume(const Handle handle, Args&&... args)
+{
+    auto* coroutine = Find(handle);
+    if (coroutine == nullptr)
+        return;
+
+    // the coroutine can start others, which can move the slots, so it is run from a copy
+    sol::coroutine function = coroutine->function;
+    const sol::protected_function_result result = function(std::forward<Args>(args)...);
+    if (!result.valid())
+    {
+        const sol::error error = result;
+        Log::Error(error.what());
+        Free(handle, false);
+        return;
+    }
+    if (result.status() != sol::call_status::yielded)
+    {
+        Free(handle, true);
+        return;
+    }
+
+    const auto wait = static_cast<Wait>(result.get<sol::optional<int>>(0).value_or(0));
+    switch (wait)
+    {
+        case Wait::Seconds:
+        {
+            const double seconds = result.get<sol::optional<double>>(1).value_or(0.0);
+            m_waitingSeconds.Schedule(m_time + std::max(seconds, 0.0), handle);
+            break;
+        }
+        case Wait::Until:
+        {
+            m_waitingUntil.push_back({handle, result.get<sol::protected_function>(1)});
+            break;
+        }
+        case Wait::Frames:
+        default:
+        {
+            const int frames = std::max(result.get<sol::optional<int>>(1).value_or(1), 1);
+            m_waitingFrames.Schedule(static_cast<double>(m_frame + frames), handle);
+            break;
+        }
+    }
+}
+
+bee::ScriptScheduler::Coroutine* bee::ScriptScheduler::Find(const Handle handle)
+{
+    if (handle.index >= m_coroutines.size())
+        return nullptr;
+
+    auto& coroutine = m_coroutines[handle.index];
+    if (coroutine.generation != handle.generation)
+        return nullptr; // finished or stopped while it waited
+
+    // the entity lost its scripts while the coroutine waited
+    if (!m_registry.valid(coroutine.entity) || !m_registry.all_of<ScriptInstanceComponent>(coroutine.entity))
+    {
+        Free(handle, false);
+        return nullptr;
+    }
+    return &coroutine;
+}
+
+void bee::ScriptScheduler::Free(const Handle handle, const bool reuseThread)
+{
+    auto& coroutine = m_coroutines[handle.index];
+    coroutine.function = sol::coroutine();
+    coroutine.entity = entt::null;
+    coroutine.generation++;
+
+    // a thread that failed or is still suspended cannot run a new function
+    if (!reuseThread)
+        coroutine.thread = sol::thread();
+    m_freeCoroutines.push_back(handle.index);
+}
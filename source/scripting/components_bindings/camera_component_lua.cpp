@@ -1,6 +1,16 @@
+#include <glm/ext/matrix_transform.hpp>
 #include <sol/sol.hpp>
 #include "scripting/components_lua.h"
 #include "ecs/components/CameraComponent.h"
+#include "scripting/glm_inplace_lua.h"
+
+namespace
+{
+void TranslateView(bee::CameraComponent& camera, const float x, const float y, const float z)
+{
+    camera.view = glm::translate(camera.view, glm::vec3(x, y, z));
+}
+} // namespace
 
 void bee::components_lua::bind_camera(sol::state& lua)
 {
@@ -9,4 +19,7 @@ void bee::components_lua::bind_camera(sol::state& lua)
     camera_table["projection"] = &CameraComponent::projection;
     camera_table["view"] = &CameraComponent::view;
     camera_table["speed"] = &CameraComponent::speed;
+
+    // changes the view without creating a userdata for it or for the translation
+    camera_table["translate_view"] = glm_lua::c_call<&TranslateView>;
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include <tuple>
+#include <sol/sol.hpp>
+#include "scripting/components_lua.h"
+#include "ecs/components/PhysicsBody2DComponent.h"
+#include "scripting/glm_inplace_lua.h"
+
+namespace
+{
+std::tuple<float, float> GetPosition(const bee::PhysicsBody2DComponent& body)
+{
+    return {body.position.x, body.position.y};
+}
+
+void SetPosition(bee::PhysicsBody2DComponent& body, const float x, const float y) { body.position = glm::vec2(x, y); }
+
+std::tuple<float, float> GetVelocity(const bee::PhysicsBody2DComponent& body)
+{
+    return {body.velocity.x, body.velocity.y};
+}
+
+void SetVelocity(bee::PhysicsBody2DComponent& body, const float x, const float y) { body.velocity = glm::vec2(x, y); }
+
+void AddVelocity(bee::PhysicsBody2DComponent& body, const float x, const float y) { body.velocity += glm::vec2(x, y); }
+
+int CollisionCount(const bee::PhysicsBody2DComponent& body) { return static_cast<int>(body.collisions.size()); }
+} // namespace
+
+void bee::components_lua::bind_physics_body_2d(sol::state& lua)
+{
+    lua.new_enum(
+        "CollisionLayer2D", "Default", CollisionLayer2D::Default, "Player", CollisionLayer2D::Player, "Projectile",
+        CollisionLayer2D::Projectile, "AreaOfEffect", CollisionLayer2D::AreaOfEffect);
+
+    sol::usertype<PhysicsBody2DComponent> body_table = lua.new_usertype<PhysicsBody2DComponent>("PhysicsBody2DComponent");
+
+    body_table["position"] = &PhysicsBody2DComponent::position;
+    body_table["velocity"] = &PhysicsBody2DComponent::velocity;
+    body_table["scale"] = &PhysicsBody2DComponent::scale;
+    body_table["layer"] = sol::readonly(&PhysicsBody2DComponent::layer);
+
+    // views that read and write the fields as plain numbers, like the ones of TransformComponent
+    body_table["get_position"] = glm_lua::c_call<&GetPosition>;
+    body_table["set_position"] = glm_lua::c_call<&SetPosition>;
+    body_table["get_velocity"] = glm_lua::c_call<&GetVelocity>;
+    body_table["set_velocity"] = glm_lua::c_call<&SetVelocity>;
+    body_table["add_velocity"] = glm_lua::c_call<&AddVelocity>;
+    body_table["collision_count"] = glm_lua::c_call<&CollisionCount>;
+}
@@ -1,6 +1,46 @@
+#include <tuple>
 #include <sol/sol.hpp>
 #include "scripting/components_lua.h"
 #include "ecs/components/TransformComponent.h"
+#include "scripting/glm_inplace_lua.h"
+
+namespace
+{
+std::tuple<float, float, float> GetPos(const bee::TransformComponent& transform)
+{
+    return {transform.pos.x, transform.pos.y, transform.pos.z};
+}
+
+void SetPos(bee::TransformComponent& transform, const float x, const float y, const float z)
+{
+    transform.pos = glm::vec3(x, y, z);
+}
+
+void Move(bee::TransformComponent& transform, const float x, const float y, const float z)
+{
+    transform.pos += glm::vec3(x, y, z);
+}
+
+std::tuple<float, float, float> GetScale(const bee::TransformComponent& transform)
+{
+    return {transform.scale.x, transform.scale.y, transform.scale.z};
+}
+
+void SetScale(bee::TransformComponent& transform, const float x, const float y, const float z)
+{
+    transform.scale = glm::vec3(x, y, z);
+}
+
+std::tuple<float, float, float, float> GetRotation(const bee::TransformComponent& transform)
+{
+    return {transform.rotation.w, transform.rotation.x, transform.rotation.y, transform.rotation.z};
+}
+
+void SetRotation(bee::TransformComponent& transform, const float w, const float x, const float y, const float z)
+{
+    transform.rotation = glm::quat(w, x, y, z);
+}
+} // namespace
 
 void bee::components_lua::bind_transform(sol::state& lua)
 {
@@ -13,4 +53,13 @@ void bee::components_lua::bind_transform(sol::state& lua)
     transform_table["pos"] = &TransformComponent::pos;
     transform_table["rotation"] = &TransformComponent::rotation;
     transform_table["scale"] = &TransformComponent::scale;
+
+    // views that read and write the fields as plain numbers, reading a field above creates a userdata pointing to it
+    transform_table["get_pos"] = glm_lua::c_call<&GetPos>;
+    transform_table["set_pos"] = glm_lua::c_call<&SetPos>;
+    transform_table["move"] = glm_lua::c_call<&Move>;
+    transform_table["get_scale"] = glm_lua::c_call<&GetScale>;
+    transform_table["set_scale"] = glm_lua::c_call<&SetScale>;
+    transform_table["get_rotation"] = glm_lua::c_call<&GetRotation>;
+    transform_table["set_rotation"] = glm_lua::c_call<&SetRotation>;
 }
\ No newline at end of file
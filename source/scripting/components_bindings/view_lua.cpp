@@ -0,0 +1,205 @@
+#include <array>
+#include <entt/entity/registry.hpp>
+#include <sol/sol.hpp>
+#include "scripting/components_lua.h"
+#include "ecs/components/CameraComponent.h"
+#include "ecs/components/PhysicsBody2DComponent.h"
+#include "ecs/components/TransformComponent.h"
+#include "scripting/EntityLua.h"
+
+namespace
+{
+constexpr int MAX_VIEW_COMPONENTS = 4;
+
+/**
+ * \brief How view reaches one type of component without knowing the type.
+ */
+struct ViewComponent
+{
+    // of the usertype, which scripts pass to view
+    const char* name;
+    entt::id_type id;
+
+    // the component of an entity, and the component at a position of the packed array of the storage
+    void* (*get)(entt::sparse_set& storage, entt::entity entity);
+    void* (*at)(entt::sparse_set& storage, size_t position);
+
+    // pushes a userdata of a pointer to the component, and points the one at index to another component
+    void (*push)(lua_State* lua);
+    void (*point)(lua_State* lua, int index, void* component);
+};
+
+template <typename T>
+ViewComponent MakeViewComponent(const char* name)
+{
+    ViewComponent component;
+    component.name = name;
+    component.id = entt::type_hash<T>::value();
+    component.get = [](entt::sparse_set& storage, const entt::entity entity) -> void*
+    { return &static_cast<entt::storage_for_t<T>&>(storage).get(entity); };
+    component.at = [](entt::sparse_set& storage, const size_t position) -> void*
+    {
+        // the reverse iterators go over the packed array from its start, like the entities of the sparse set
+        return &static_cast<entt::storage_for_t<T>&>(storage).rbegin()[static_cast<std::ptrdiff_t>(position)];
+    };
+    component.push = [](lua_State* lua)
+    {
+        static T placeholder;
+        sol::stack::push(lua, &placeholder);
+    };
+    component.point = [](lua_State* lua, const int index, void* pointer)
+    {
+        // sol keeps the pointer at the aligned start of the userdata, the same way it reads it back
+        void* memory = sol::detail::align_usertype_pointer(lua_touserdata(lua, index));
+        *static_cast<T**>(memory) = static_cast<T*>(pointer);
+    };
+    return component;
+}
+
+const std::array<ViewComponent, 3> VIEW_COMPONENTS = {
+    MakeViewComponent<bee::TransformComponent>("TransformComponent"),
+    MakeViewComponent<bee::CameraComponent>("CameraComponent"),
+    MakeViewComponent<bee::PhysicsBody2DComponent>("PhysicsBody2DComponent")};
+
+/**
+ * \brief The state of one loop over a view, the second value view returns.
+ */
+struct ViewIterator
+{
+    struct Column
+    {
+        const ViewComponent* type = nullptr;
+        entt::sparse_set* storage = nullptr;
+
+        // given to the script for every entity, pointing to the component of that entity
+        sol::reference object;
+    };
+
+    // the smallest storage, its entities are the ones checked, nullptr if a storage does not exist yet
+    entt::sparse_set* lead = nullptr;
+    size_t position = 0;
+
+    std::array<Column, MAX_VIEW_COMPONENTS> columns;
+    int columnCount = 0;
+
+    // given to the script for every entity
+    sol::reference entity;
+};
+
+int Next(lua_State* lua)
+{
+    auto& iterator = sol::stack::get<ViewIterator&>(lua, 1);
+    if (iterator.lead == nullptr)
+    {
+        lua_pushnil(lua);
+        return 1;
+    }
+
+    const entt::entity* entities = iterator.lead->data();
+    while (iterator.position < iterator.lead->size())
+    {
+        const size_t position = iterator.position++;
+        const entt::entity entity = entities[position];
+
+        // storages that delete in place leave tombstones in the packed array
+        if (entity == entt::tombstone)
+            continue;
+
+        bool hasAll = true;
+        for (int column = 0; column < iterator.columnCount && hasAll; column++)
+        {
+            const auto* storage = iterator.columns[column].storage;
+            hasAll = storage == iterator.lead || storage->contains(entity);
+        }
+        if (!hasAll)
+            continue;
+
+        iterator.entity.push(lua);
+        sol::stack::get<bee::EntityLua&>(lua, -1).m_entityID = entity;
+        for (int column = 0; column < iterator.columnCount; column++)
+        {
+            auto& [type, storage, object] = iterator.columns[column];
+            object.push(lua);
+            type->point(lua, -1, storage == iterator.lead ? type->at(*storage, position) : type->get(*storage, entity));
+        }
+        return 1 + iterator.columnCount;
+    }
+
+    lua_pushnil(lua);
+    return 1;
+}
+
+/**
+ * \brief The upvalues are the registry and the usertypes of VIEW_COMPONENTS, in the same order.
+ */
+int View(lua_State* lua)
+{
+    auto& registry = *static_cast<entt::registry*>(lua_touserdata(lua, lua_upvalueindex(1)));
+    const int count = lua_gettop(lua);
+    if (count == 0 || count > MAX_VIEW_COMPONENTS)
+        return luaL_error(lua, "view takes 1 to %d component types", MAX_VIEW_COMPONENTS);
+
+    // checked before anything that has to be destroyed exists, a Lua error does not unwind the C++ stack
+    std::array<const ViewComponent*, MAX_VIEW_COMPONENTS> types = {};
+    for (int arg = 1; arg <= count; arg++)
+    {
+        for (size_t type = 0; type < VIEW_COMPONENTS.size(); type++)
+        {
+            if (lua_rawequal(lua, arg, lua_upvalueindex(2 + static_cast<int>(type))) != 0)
+                types[arg - 1] = &VIEW_COMPONENTS[type];
+        }
+        if (types[arg - 1] == nullptr)
+            return luaL_argerror(lua, arg, "not a component type that view can go over");
+    }
+
+    ViewIterator iterator;
+    iterator.columnCount = count;
+    bool empty = false;
+    for (int column = 0; column < count; column++)
+    {
+        auto& [type, storage, object] = iterator.columns[column];
+        type = types[column];
+        storage = registry.storage(type->id);
+        if (storage == nullptr)
+        {
+            empty = true;
+        }
+        else if (iterator.lead == nullptr || storage->size() < iterator.lead->size())
+        {
+            iterator.lead = storage;
+        }
+    }
+
+    if (empty)
+    {
+        iterator.lead = nullptr;
+    }
+    else
+    {
+        iterator.entity = sol::make_reference(lua, bee::EntityLua(entt::entity{entt::null}));
+        for (int column = 0; column < count; column++)
+        {
+            auto& [type, storage, object] = iterator.columns[column];
+            type->push(lua);
+            object = sol::reference(lua, -1);
+            lua_pop(lua, 1);
+        }
+    }
+
+    lua_pushcfunction(lua, &Next);
+    sol::stack::push(lua, std::move(iterator));
+    return 2;
+}
+} // namespace
+
+void bee::components_lua::bind_view(sol::state& lua, entt::registry& registry)
+{
+    lua_State* state = lua.lua_state();
+    lua_pushlightuserdata(state, &registry);
+    for (const auto& component : VIEW_COMPONENTS)
+    {
+        lua_getglobal(state, component.name);
+    }
+    lua_pushcclosure(state, &View, 1 + static_cast<int>(VIEW_COMPONENTS.size()));
+    lua_setglobal(state, "view");
+}
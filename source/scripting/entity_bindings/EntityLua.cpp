@@ -1,21 +1,38 @@
 #include "scripting/EntityLua.h"
 
-#include "core/engine.hpp"
-#include "ecs/ECS.h"
+#include <entt/entity/registry.hpp>
+
 #include "ecs/components/CameraComponent.h"
+#include "ecs/components/PhysicsBody2DComponent.h"
 #include "ecs/components/TransformComponent.h"
+#include "scripting/StagedComponents.h"
 
 bee::EntityLua::EntityLua(const entt::entity& entity)
     :m_entityID(entity)
 {}
 
-void bee::entity_lua::bind_entity_class(sol::state& lua)
+void bee::entity_lua::bind_entity_class(sol::state& lua, entt::registry& registry)
+{
+    sol::usertype<EntityLua> entity_table =
+        lua.new_usertype<EntityLua>("EntityLua", sol::constructors<EntityLua(const entt::entity& entity)>());
+
+    entity_table["GetTransform"] = [&registry](const EntityLua& entity)
+    { return registry.try_get<TransformComponent>(entity.m_entityID); };
+    entity_table["GetCamera"] = [&registry](const EntityLua& entity)
+    { return registry.try_get<CameraComponent>(entity.m_entityID); };
+    entity_table["GetPhysicsBody2D"] = [&registry](const EntityLua& entity)
+    { return registry.try_get<PhysicsBody2DComponent>(entity.m_entityID); };
+}
+
+void bee::entity_lua::bind_entity_class(sol::state& lua, const entt::registry& registry, StagedComponents& staged)
 {
     sol::usertype<EntityLua> entity_table =
         lua.new_usertype<EntityLua>("EntityLua", sol::constructors<EntityLua(const entt::entity& entity)>());
 
-    entity_table["GetTransform"] = [](const EntityLua& entity)
-    { return Engine.ECS().Registry().try_get<TransformComponent>(entity.m_entityID); };
-    entity_table["GetCamera"] = [](const EntityLua& entity)
-    { return Engine.ECS().Registry().try_get<CameraComponent>(entity.m_entityID); };
-}
\ No newline at end of file
+    entity_table["GetTransform"] = [&registry, &staged](const EntityLua& entity)
+    { return staged.Get<TransformComponent>(registry, entity.m_entityID); };
+    entity_table["GetCamera"] = [&registry, &staged](const EntityLua& entity)
+    { return staged.Get<CameraComponent>(registry, entity.m_entityID); };
+    entity_table["GetPhysicsBody2D"] = [&registry, &staged](const EntityLua& entity)
+    { return staged.Get<PhysicsBody2DComponent>(registry, entity.m_entityID); };
+}
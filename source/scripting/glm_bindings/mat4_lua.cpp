@@ -2,6 +2,17 @@
 #include <glm/gtx/quaternion.hpp>
 #include <sol/sol.hpp>
 #include "scripting/glm_lua.h"
+#include "scripting/glm_inplace_lua.h"
+
+namespace
+{
+void SetIdentity(glm::mat4& m) { m = glm::mat4(1.f); }
+void Translate(glm::mat4& m, const glm::vec3& translation) { m = glm::translate(m, translation); }
+void TranslateComponents(glm::mat4& m, const float x, const float y, const float z)
+{
+    m = glm::translate(m, glm::vec3(x, y, z));
+}
+} // namespace
 
 void bee::glm_lua::bind_mat4(sol::state& lua)
 {
@@ -22,4 +33,11 @@ void bee::glm_lua::bind_mat4(sol::state& lua)
 
     mat4_table["ortho"] = [](float left, float right, float bottom, float top, float zNear, float zFar)
     { return glm::ortho(left, right, bottom, top, zNear, zFar); };
+
+    // in place, these change the matrix they are called on and return nothing
+    mat4_table["set"] = c_call<&inplace::Assign<glm::mat4>>;
+    mat4_table["set_identity"] = c_call<&SetIdentity>;
+    mat4_table["mul_assign"] = c_call<&inplace::MulAssign<glm::mat4>>;
+    mat4_table["translate_inplace"] = c_call<&Translate, &TranslateComponents>;
+    bind_scratch(lua, mat4_table, glm::mat4(1.f));
 }
\ No newline at end of file
@@ -2,6 +2,13 @@
 #include <glm/gtx/quaternion.hpp>
 #include <sol/sol.hpp>
 #include "scripting/glm_lua.h"
+#include "scripting/glm_inplace_lua.h"
+
+namespace
+{
+void Set(glm::quat& q, const float w, const float x, const float y, const float z) { q = glm::quat(w, x, y, z); }
+void Rotate(glm::quat& q, const float angle, const glm::vec3& axis) { q = glm::rotate(q, angle, axis); }
+} // namespace
 
 void bee::glm_lua::bind_quat(sol::state& lua)
 {
@@ -32,4 +39,11 @@ void bee::glm_lua::bind_quat(sol::state& lua)
     quat_table["identity"] = []() { return glm::quat(); };
     quat_table["from_mat4"] = [](const glm::mat4& m) { return glm::quat_cast(m); };
     quat_table["from_mat3"] = [](const glm::mat3& m) { return glm::quat_cast(m); };
+
+    // in place, these change the quaternion they are called on and return nothing
+    quat_table["set"] = c_call<&Set, &inplace::Assign<glm::quat>>;
+    quat_table["mul_assign"] = c_call<&inplace::MulAssign<glm::quat>>;
+    quat_table["rotate_inplace"] = c_call<&Rotate>;
+    quat_table["normalize_inplace"] = c_call<&inplace::Normalize<glm::quat>>;
+    bind_scratch(lua, quat_table, glm::quat());
 }
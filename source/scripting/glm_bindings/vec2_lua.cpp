@@ -1,6 +1,12 @@
 #include <glm/glm.hpp>
 #include <sol/sol.hpp>
 #include "scripting/glm_lua.h"
+#include "scripting/glm_inplace_lua.h"
+
+namespace
+{
+void Set(glm::vec2& v, const float x, const float y) { v = glm::vec2(x, y); }
+} // namespace
 
 void bee::glm_lua::bind_vec2(sol::state& lua)
 {
@@ -21,4 +27,13 @@ void bee::glm_lua::bind_vec2(sol::state& lua)
     vec2_table["length"] = [](const glm::vec2& v) { return glm::length(v); };
     vec2_table["normalize"] = [](const glm::vec2& v) { return glm::normalize(v); };
     vec2_table["dot"] = [](const glm::vec2& lhs, const glm::vec2& rhs) { return glm::dot(lhs, rhs); };
+
+    // in place, these change the vector they are called on and return nothing, so they do not create a userdata
+    vec2_table["set"] = c_call<&Set, &inplace::Assign<glm::vec2>>;
+    vec2_table["add_assign"] = c_call<&inplace::AddAssign<glm::vec2>>;
+    vec2_table["sub_assign"] = c_call<&inplace::SubAssign<glm::vec2>>;
+    vec2_table["add_scaled"] = c_call<&inplace::AddScaled<glm::vec2>>;
+    vec2_table["scale_inplace"] = c_call<&inplace::Scale<glm::vec2>>;
+    vec2_table["normalize_inplace"] = c_call<&inplace::Normalize<glm::vec2>>;
+    bind_scratch(lua, vec2_table, glm::vec2(0.f));
 }
@@ -1,6 +1,12 @@
 #include <glm/glm.hpp>
 #include <sol/sol.hpp>
 #include "scripting/glm_lua.h"
+#include "scripting/glm_inplace_lua.h"
+
+namespace
+{
+void Set(glm::vec3& v, const float x, const float y, const float z) { v = glm::vec3(x, y, z); }
+} // namespace
 
 void bee::glm_lua::bind_vec3(sol::state& lua)
 {
@@ -23,4 +29,13 @@ void bee::glm_lua::bind_vec3(sol::state& lua)
     vec3_table["normalize"] = [](const glm::vec3& v) { return glm::normalize(v); };
     vec3_table["dot"] = [](const glm::vec3& lhs, const glm::vec3& rhs) { return glm::dot(lhs, rhs); };
     vec3_table["cross"] = [](const glm::vec3& lhs, const glm::vec3& rhs) { return glm::cross(lhs, rhs); };
+
+    // in place, these change the vector they are called on and return nothing, so they do not create a userdata
+    vec3_table["set"] = c_call<&Set, &inplace::Assign<glm::vec3>>;
+    vec3_table["add_assign"] = c_call<&inplace::AddAssign<glm::vec3>>;
+    vec3_table["sub_assign"] = c_call<&inplace::SubAssign<glm::vec3>>;
+    vec3_table["add_scaled"] = c_call<&inplace::AddScaled<glm::vec3>>;
+    vec3_table["scale_inplace"] = c_call<&inplace::Scale<glm::vec3>>;
+    vec3_table["normalize_inplace"] = c_call<&inplace::Normalize<glm::vec3>>;
+    bind_scratch(lua, vec3_table, glm::vec3(0.f));
 }
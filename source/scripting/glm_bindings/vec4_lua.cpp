@@ -1,6 +1,12 @@
 #include <glm/glm.hpp>
 #include <sol/sol.hpp>
 #include "scripting/glm_lua.h"
+#include "scripting/glm_inplace_lua.h"
+
+namespace
+{
+void Set(glm::vec4& v, const float x, const float y, const float z, const float w) { v = glm::vec4(x, y, z, w); }
+} // namespace
 
 void bee::glm_lua::bind_vec4(sol::state& lua)
 {
@@ -23,4 +29,13 @@ void bee::glm_lua::bind_vec4(sol::state& lua)
     vec4_table["length"] = [](const glm::vec4& v) { return glm::length(v); };
     vec4_table["normalize"] = [](const glm::vec4& v) { return glm::normalize(v); };
     vec4_table["dot"] = [](const glm::vec4& lhs, const glm::vec4& rhs) { return glm::dot(lhs, rhs); };
+
+    // in place, these change the vector they are called on and return nothing, so they do not create a userdata
+    vec4_table["set"] = c_call<&Set, &inplace::Assign<glm::vec4>>;
+    vec4_table["add_assign"] = c_call<&inplace::AddAssign<glm::vec4>>;
+    vec4_table["sub_assign"] = c_call<&inplace::SubAssign<glm::vec4>>;
+    vec4_table["add_scaled"] = c_call<&inplace::AddScaled<glm::vec4>>;
+    vec4_table["scale_inplace"] = c_call<&inplace::Scale<glm::vec4>>;
+    vec4_table["normalize_inplace"] = c_call<&inplace::Normalize<glm::vec4>>;
+    bind_scratch(lua, vec4_table, glm::vec4(0.f));
 }
@@ -1,10 +1,9 @@
 #include <sol/sol.hpp>
 #include "scripting/input_lua.h"
 
-#include "core/engine.hpp"
 #include "core/input.hpp"
 
-void bee::input_lua::bind(sol::state& lua)
+void bee::input_lua::bind(sol::state& lua, const Input* input)
 {
     auto keyboard_enum = lua.new_enum(
         "KeyboardKey",
@@ -16,7 +15,8 @@ void bee::input_lua::bind(sol::state& lua)
         "E", Input::KeyboardKey::E, 
         "Space", Input::KeyboardKey::Space);
 
-    lua.set_function("GetKeyboardKey", [](const Input::KeyboardKey key) { return Engine.Input().GetKeyboardKey(key); });
+    lua.set_function(
+        "GetKeyboardKey", [input](const Input::KeyboardKey key) { return input != nullptr && input->GetKeyboardKey(key); });
 
     auto mouse_enum = lua.new_enum(
         "MouseButton", 
@@ -24,7 +24,9 @@ void bee::input_lua::bind(sol::state& lua)
         "Right", Input::MouseButton::Right, 
         "Middle", Input::MouseButton::Middle);
 
-    lua.set_function("GetMouseButton", [](const Input::MouseButton button) { return Engine.Input().GetMouseButton(button); });
+    lua.set_function(
+        "GetMouseButton",
+        [input](const Input::MouseButton button) { return input != nullptr && input->GetMouseButton(button); });
 
-    lua.set_function("GetMouseDelta", []() { return Engine.Input().GetMouseDelta(); });
+    lua.set_function("GetMouseDelta", [input]() { return input != nullptr ? input->GetMouseDelta() : glm::vec2(0.f); });
 }
@@ -0,0 +1,278 @@
+#include "tools/CombatSimulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <entt/entity/registry.hpp>
+#include <glm/geometric.hpp>
+
+#include "ecs/components/PhysicsBody2DComponent.h"
+#include "ecs/components/PlayerStatsComponents.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/ECS.h"
+#include "resource_managers/AbilityManager.h"
+#include "tools/Random.h"
+#include "tools/log.hpp"
+
+namespace
+{
+struct Bot
+{
+    entt::entity player = entt::null;
+    entt::entity opponent = entt::null;
+    bee::AbilityID ability = 0;
+    float preferredDistance = 10.f; // between the centers of the players
+    float nextCastTime = 0.f;
+    float aimError = 0.f; // in radians, rolled again after every cast
+};
+
+// the distance between the centers of two players at which the ability can still hit, all players have the same radius
+float Reach(const bee::AbilitySettings& ability, const float playerRadius)
+{
+    if (ability.targetTeam == bee::Target::Self)
+        return playerRadius * 2.f;
+    if (ability.castType == bee::CastType::RadiusAroundPlayer)
+        return ability.aoeRadius + playerRadius;
+    // projectiles spawn just outside their caster
+    return playerRadius * 2.f + ability.projectileRadius * 2.f + ability.projectileRange;
+}
+
+// the same rules the scene applies to player input, with a bot deciding where to go and when to cast
+void UpdateBot(
+    entt::registry& registry, Bot& bot, const bee::AbilitySettings& ability, const float time, bee::RandomStream& random)
+{
+    auto& playerStats = registry.get<bee::PlayerStatsComponent>(bot.player);
+    auto& body = registry.get<bee::PhysicsBody2DComponent>(bot.player);
+    auto& actions = registry.get<bee::PlayerActionsComponent>(bot.player);
+    actions.held = 0;
+    actions.pressed = 0;
+    if (playerStats.state & bee::PlayerStatsComponent::State::Dashing)
+        return;
+    if (playerStats.state & bee::PlayerStatsComponent::State::Rooted ||
+        playerStats.state & bee::PlayerStatsComponent::State::Stunned)
+    {
+        body.velocity = glm::vec2(0.f);
+        return;
+    }
+
+    const glm::vec2 toOpponent = registry.get<bee::PhysicsBody2DComponent>(bot.opponent).position - body.position;
+    const float distance = glm::length(toOpponent);
+    const float angle = std::atan2(toOpponent.y, toOpponent.x) + bot.aimError;
+    // players face where they move, so a bot in range keeps creeping forward to stay aimed
+    const float speed = distance > bot.preferredDistance ? 1.f : 0.05f;
+    body.velocity = glm::vec2(std::cos(angle), std::sin(angle)) * playerStats.currentMovementSpeed * speed;
+
+    const bool canCast = !(playerStats.state & bee::PlayerStatsComponent::State::Silenced) &&
+                         playerStats.currentAmmo >= 1.f && time >= bot.nextCastTime;
+    const bool inRange = ability.targetTeam == bee::Target::Self || distance <= bot.preferredDistance * 1.25f;
+    if (canCast && inRange)
+    {
+        // cast through the ability action, like a player pressing the button
+        actions.held = bee::PlayerActionsComponent::Bit(bee::PlayerActionsComponent::AbilitySlot(0));
+        actions.pressed = actions.held;
+        bot.nextCastTime = time + random.Range(0.15f, 0.4f); // reaction time
+        bot.aimError = random.Range(-0.15f, 0.15f);
+    }
+}
+
+// nearest rank percentile of sorted values
+float Percentile(const std::vector<float>& sortedValues, const float percentile)
+{
+    if (sortedValues.empty())
+        return 0.f;
+    const auto rank = static_cast<size_t>(std::ceil(percentile / 100.f * static_cast<float>(sortedValues.size())));
+    return sortedValues[std::clamp<size_t>(rank, 1, sortedValues.size()) - 1];
+}
+} // namespace
+
+bee::CombatSimulator::CombatSimulator(const AbilityManager& abilityManager) : m_abilityManager(abilityManager) {}
+
+void bee::CombatSimulator::Run(const CombatSimulationSettings& settings)
+{
+    // sorted by name so the same library gives the same matches, whatever order it was loaded in
+    std::vector<AbilityID> abilities;
+    m_abilityManager.ForEach([&abilities](const AbilityID id, const std::string&, const AbilitySettings&)
+                             { abilities.push_back(id); });
+    std::sort(
+        abilities.begin(), abilities.end(),
+        [this](const AbilityID a, const AbilityID b) { return m_abilityManager.GetName(a) < m_abilityManager.GetName(b); });
+    if (abilities.empty() || settings.matches <= 0)
+    {
+        Log::Error("Combat simulation needs at least one saved ability and one match");
+        return;
+    }
+
+    const unsigned threadCount =
+        settings.threads != 0 ? settings.threads : std::max(std::thread::hardware_concurrency(), 1u);
+
+    // every match writes only its own result, so the report does not depend on which thread ran what
+    std::vector<MatchResult> results(static_cast<size_t>(settings.matches));
+    std::atomic<int> nextMatch{0};
+    const auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back(
+            [this, &settings, &abilities, &results, &nextMatch]
+            {
+                for (int match = nextMatch++; match < settings.matches; match = nextMatch++)
+                {
+                    results[match] = RunMatch(settings, static_cast<uint64_t>(match), abilities);
+                }
+            });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    const double wallTime =
+        std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    float simulatedTime = 0.f;
+    for (const auto& result : results)
+    {
+        simulatedTime += result.duration;
+    }
+    PrintReport(results, wallTime, simulatedTime);
+}
+
+bee::CombatSimulator::MatchResult bee::CombatSimulator::RunMatch(
+    const CombatSimulationSettings& settings, const uint64_t matchIndex, const std::vector<AbilityID>& abilities) const
+{
+    RandomStream random(settings.seed, matchIndex);
+    MatchResult result;
+
+    // a world of its own, only the ability library is shared with the other matches
+    WorldContext context;
+    context.abilityManager = &m_abilityManager;
+    context.headless = true;
+    ECS world(context);
+    auto& registry = world.Registry();
+
+    Bot bots[2];
+    float lastHealth[2] = {0.f, 0.f};
+    for (int i = 0; i < 2; i++)
+    {
+        result.abilities[i] = abilities[random.NextUInt(static_cast<uint32_t>(abilities.size()))];
+
+        const auto player = registry.create();
+        const auto& playerStats = registry.emplace<PlayerStatsComponent>(player, i, i);
+        auto& body = registry.emplace<PhysicsBody2DComponent>(player);
+        body.position = {(static_cast<float>(i) - 0.5f) * settings.spawnDistance, 0.f};
+        body.scale = 2.f;
+        body.layer = CollisionLayer2D::Player;
+        auto& transformComponent = registry.emplace<TransformComponent>(player);
+        transformComponent.pos.y = body.scale;
+        transformComponent.scale.y = body.scale;
+        auto& actions = registry.emplace<PlayerActionsComponent>(player);
+        actions.abilitySlots[0] = result.abilities[i];
+        actions.abilitySlotCount = 1;
+
+        bots[i].player = player;
+        bots[i].ability = result.abilities[i];
+        bots[i].preferredDistance = Reach(m_abilityManager.Get(result.abilities[i]), body.scale) * 0.8f;
+        bots[i].nextCastTime = random.Range(0.f, 0.5f);
+        lastHealth[i] = playerStats.currentHealth;
+    }
+    bots[0].opponent = bots[1].player;
+    bots[1].opponent = bots[0].player;
+
+    float time = 0.f;
+    bool finished = false;
+    while (!finished && time < settings.maxMatchTime)
+    {
+        // bots act where the scene handles player input, before the systems update
+        for (auto& bot : bots)
+        {
+            UpdateBot(registry, bot, m_abilityManager.Get(bot.ability), time, random);
+        }
+        world.Update(settings.timeStep);
+        time += settings.timeStep;
+
+        bool dead[2] = {false, false};
+        for (int i = 0; i < 2; i++)
+        {
+            const float health = registry.get<PlayerStatsComponent>(bots[i].player).currentHealth;
+            if (health < lastHealth[i])
+                result.damageDealt[1 - i] += lastHealth[i] - health;
+            lastHealth[i] = health;
+            dead[i] = health <= 0.f;
+        }
+        finished = dead[0] || dead[1];
+        if (dead[0] != dead[1])
+            result.winner = dead[0] ? 1 : 0;
+    }
+    result.duration = time;
+    return result;
+}
+
+void bee::CombatSimulator::PrintReport(
+    const std::vector<MatchResult>& results, const double wallTime, const float simulatedTime) const
+{
+    struct AbilityStats
+    {
+        int matches = 0;
+        int wins = 0;
+        int draws = 0;
+        std::vector<float> timesToKill;
+        std::vector<float> damage;
+    };
+
+    std::vector<AbilityStats> stats;
+    for (const auto& result : results)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            const AbilityID ability = result.abilities[i];
+            if (ability >= stats.size())
+                stats.resize(ability + 1);
+            auto& abilityStats = stats[ability];
+            abilityStats.matches++;
+            abilityStats.damage.push_back(result.damageDealt[i]);
+            if (result.winner == i)
+            {
+                abilityStats.wins++;
+                abilityStats.timesToKill.push_back(result.duration);
+            }
+            else if (result.winner == -1)
+            {
+                abilityStats.draws++;
+            }
+        }
+    }
+
+    printf(
+        "%zu matches, %.0f s simulated in %.2f s (%.0fx real time)\n", results.size(), simulatedTime, wallTime,
+        wallTime > 0.0 ? simulatedTime / wallTime : 0.0);
+    printf(
+        "%-24s %8s %7s %7s %8s %8s %8s %8s %8s\n", "ability", "matches", "win %", "draw %", "ttk p50", "ttk p90", "dmg p10",
+        "dmg p50", "dmg p90");
+
+    std::vector<AbilityID> order;
+    for (AbilityID id = 0; id < static_cast<AbilityID>(stats.size()); id++)
+    {
+        if (stats[id].matches > 0)
+            order.push_back(id);
+    }
+    std::sort(
+        order.begin(), order.end(),
+        [this](const AbilityID a, const AbilityID b) { return m_abilityManager.GetName(a) < m_abilityManager.GetName(b); });
+
+    for (const AbilityID id : order)
+    {
+        auto& abilityStats = stats[id];
+        std::sort(abilityStats.timesToKill.begin(), abilityStats.timesToKill.end());
+        std::sort(abilityStats.damage.begin(), abilityStats.damage.end());
+        const float matches = static_cast<float>(abilityStats.matches);
+        printf(
+            "%-24s %8d %7.1f %7.1f %8.2f %8.2f %8.1f %8.1f %8.1f\n", m_abilityManager.GetName(id).c_str(),
+            abilityStats.matches, 100.f * static_cast<float>(abilityStats.wins) / matches,
+            100.f * static_cast<float>(abilityStats.draws) / matches, Percentile(abilityStats.timesToKill, 50.f),
+            Percentile(abilityStats.timesToKill, 90.f), Percentile(abilityStats.damage, 10.f),
+            Percentile(abilityStats.damage, 50.f), Percentile(abilityStats.damage, 90.f));
+    }
+}
@@ -0,0 +1,109 @@
+#include "tools/FileWatcher.h"
+
+#include <algorithm>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "tools/log.hpp"
+
+bee::FileWatcher::FileWatcher(std::string directory, std::string extension, const float pollInterval)
+    : m_directory(std::move(directory)), m_extension(std::move(extension)), m_pollInterval(pollInterval)
+{
+    if (!m_directory.empty() && m_directory.back() != '/')
+        m_directory += '/';
+
+#if defined(__linux__)
+    // editors either write the file in place or write a copy and move it over the file
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify >= 0 && inotify_add_watch(m_inotify, m_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0)
+        return;
+
+    if (m_inotify >= 0)
+    {
+        close(m_inotify);
+        m_inotify = -1;
+    }
+    Log::Warn("Cannot watch {} with inotify, polling it instead", m_directory);
+#endif
+
+    // the files that exist now are not changes
+    Scan(nullptr);
+}
+
+bee::FileWatcher::~FileWatcher()
+{
+#if defined(__linux__)
+    if (m_inotify >= 0)
+        close(m_inotify);
+#endif
+}
+
+std::vector<std::string> bee::FileWatcher::Poll(const float dt)
+{
+    std::vector<std::string> changed;
+
+#if defined(__linux__)
+    if (m_inotify >= 0)
+    {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0)
+        {
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                if (event->len == 0 || (event->mask & IN_ISDIR) != 0 || !HasExtension(event->name))
+                    continue;
+
+                std::string path = m_directory + event->name;
+                if (std::find(changed.begin(), changed.end(), path) == changed.end())
+                    changed.push_back(std::move(path));
+            }
+        }
+        return changed;
+    }
+#endif
+
+    m_timeSinceScan += dt;
+    if (m_timeSinceScan >= m_pollInterval)
+    {
+        m_timeSinceScan = 0.f;
+        Scan(&changed);
+    }
+    return changed;
+}
+
+void bee::FileWatcher::Scan(std::vector<std::string>* changed)
+{
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, error))
+    {
+        const std::string fileName = entry.path().filename().string();
+        if (!entry.is_regular_file(error) || !HasExtension(fileName))
+            continue;
+
+        const auto writeTime = entry.last_write_time(error);
+        if (error)
+            continue;
+
+        std::string path = m_directory + fileName;
+        auto [it, added] = m_writeTimes.try_emplace(path, writeTime);
+        if (!added && it->second == writeTime)
+            continue;
+
+        it->second = writeTime;
+        if (changed != nullptr)
+            changed->push_back(std::move(path));
+    }
+}
+
+bool bee::FileWatcher::HasExtension(const std::string& fileName) const
+{
+    return fileName.size() >= m_extension.size() &&
+           fileName.compare(fileName.size() - m_extension.size(), m_extension.size(), m_extension) == 0;
+}
@@ -1,5 +1,6 @@
 #include "tools/Hierarchy.h"
 
+#include <algorithm>
 #include <imgui.h>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -171,16 +172,9 @@ void bee::Hierarchy::DisplayEditor()
         {
             DestroyEntityAndChildren(m_selectedNode);
             Engine.ResourceManager().GetModelManager().RemoveEntity(m_selectedNode);
-            auto& rootHierarchyComponent = m_registry.get<HierarchyComponent>(m_theoreticalRoot);
-            for (auto it = rootHierarchyComponent.children.begin(); it != rootHierarchyComponent.children.end(); ++it)
-            {
-                if (*it == m_selectedNode)
-                {
-                    rootHierarchyComponent.children.erase(it);
-                    break;
-                }
-            }
+            DetachFromParent(m_registry, m_selectedNode);
             m_registry.destroy(m_selectedNode);
+            auto& rootHierarchyComponent = m_registry.get<HierarchyComponent>(m_theoreticalRoot);
             m_selectedNode = m_theoreticalRoot;
             rootHierarchyComponent.isSelected = true;
         }
@@ -195,9 +189,12 @@ void bee::Hierarchy::DisplayEditor()
 
 void bee::Hierarchy::DestroyEntityAndChildren(entt::entity& parent)
 {
-    auto& hierarchyComponent = m_registry.get<HierarchyComponent>(parent);
-    for (auto& entity : hierarchyComponent.children)
+    // destroying an entity moves the components of the storage around, and up to 4 children live inside the component,
+    // so the component is fetched again for every child instead of iterating over it
+    const size_t childCount = m_registry.get<HierarchyComponent>(parent).children.size();
+    for (size_t i = 0; i < childCount; i++)
     {
+        entt::entity entity = m_registry.get<HierarchyComponent>(parent).children[i];
         DestroyEntityAndChildren(entity);
         m_registry.destroy(entity);
     }
@@ -245,3 +242,40 @@ void bee::Hierarchy::Init()
 }
 
 void bee::Hierarchy::SetSelected(entt::entity entity) { m_selectedNode = entity; }
+
+void bee::AttachToParent(entt::registry& registry, const entt::entity entity, const entt::entity parent)
+{
+    auto& hierarchyComponent = registry.get_or_emplace<HierarchyComponent>(entity);
+    auto& siblings = registry.get<HierarchyComponent>(parent).children;
+    hierarchyComponent.parent = parent;
+    hierarchyComponent.indexInParent = static_cast<uint32_t>(siblings.size());
+    siblings.push_back(entity);
+}
+
+void bee::DetachFromParent(entt::registry& registry, const entt::entity entity)
+{
+    auto& hierarchyComponent = registry.get<HierarchyComponent>(entity);
+    const entt::entity parent = hierarchyComponent.parent;
+    hierarchyComponent.parent = entt::null;
+    if (parent == entt::null || !registry.valid(parent))
+        return;
+
+    auto& siblings = registry.get<HierarchyComponent>(parent).children;
+    size_t index = hierarchyComponent.indexInParent;
+    if (index >= siblings.size() || siblings[index] != entity)
+    {
+        // not attached through AttachToParent, or the children were rebuilt since
+        const auto it = std::find(siblings.begin(), siblings.end(), entity);
+        if (it == siblings.end())
+            return;
+        index = static_cast<size_t>(it - siblings.begin());
+    }
+
+    siblings[index] = siblings.back();
+    siblings.pop_back();
+    if (index < siblings.size())
+    {
+        if (auto* movedSibling = registry.try_get<HierarchyComponent>(siblings[index]))
+            movedSibling->indexInParent = static_cast<uint32_t>(index);
+    }
+}
@@ -23,6 +23,10 @@ void bee::MainMenuBar::Display(const float& dt)
         {
             m_windowsToDisplayFlags ^= WindowsToDisplay::Hierarchy;
         }
+        if (ImGui::MenuItem("Script Profiler", nullptr, m_windowsToDisplayFlags & WindowsToDisplay::ScriptProfiler))
+        {
+            m_windowsToDisplayFlags ^= WindowsToDisplay::ScriptProfiler;
+        }
         ImGui::EndMenu();
     }
     ImGui::Text("|");
@@ -0,0 +1,150 @@
+#include "tools/Random.h"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BEE_RANDOM_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+std::atomic<uint64_t> g_threadSeed{0x2545f4914f6cdd1dull};
+std::atomic<uint64_t> g_nextThreadStream{0};
+
+// floats are built from the upper 24 bits, all a float mantissa can hold, which also skips xoshiro128+'s weak low bits
+constexpr float TO_UNIT_FLOAT = 1.f / 16777216.f;
+
+#ifndef BEE_RANDOM_SSE2
+inline uint32_t RotateLeft(const uint32_t value, const int count) { return (value << count) | (value >> (32 - count)); }
+#endif
+} // namespace
+
+bee::RandomStream::RandomStream(const uint64_t seed, const uint64_t streamId) { Seed(seed, streamId); }
+
+void bee::RandomStream::Seed(const uint64_t seed, const uint64_t streamId)
+{
+    // standard pcg32 seeding sequence
+    m_state = 0;
+    m_increment = (streamId << 1u) | 1u;
+    NextUInt();
+    m_state += seed;
+    NextUInt();
+
+    for (auto& word : m_lanes)
+    {
+        for (uint32_t& lane : word)
+        {
+            lane = NextUInt();
+        }
+    }
+
+    // a xoshiro lane must never be all zeros
+    for (int lane = 0; lane < 4; lane++)
+    {
+        if ((m_lanes[0][lane] | m_lanes[1][lane] | m_lanes[2][lane] | m_lanes[3][lane]) == 0)
+            m_lanes[0][lane] = 1;
+    }
+}
+
+uint32_t bee::RandomStream::NextUInt()
+{
+    const uint64_t oldState = m_state;
+    m_state = oldState * 6364136223846793005ull + m_increment;
+    const auto xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+    const auto rotation = static_cast<uint32_t>(oldState >> 59u);
+    return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+}
+
+uint32_t bee::RandomStream::NextUInt(const uint32_t bound)
+{
+    if (bound == 0)
+        return 0;
+
+    // reject the few values at the bottom of the range that would make the modulo biased
+    const uint32_t threshold = (~bound + 1u) % bound;
+    while (true)
+    {
+        const uint32_t value = NextUInt();
+        if (value >= threshold)
+            return value % bound;
+    }
+}
+
+float bee::RandomStream::NextFloat() { return static_cast<float>(NextUInt() >> 8) * TO_UNIT_FLOAT; }
+
+float bee::RandomStream::Range(const float min, const float max) { return min + NextFloat() * (max - min); }
+
+void bee::RandomStream::FillRange(float* out, const size_t count, const float min, const float max)
+{
+    const float scale = (max - min) * TO_UNIT_FLOAT;
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        NextBatch(out + i, min, scale);
+    }
+
+    if (i < count)
+    {
+        float tail[4];
+        NextBatch(tail, min, scale);
+        std::memcpy(out + i, tail, (count - i) * sizeof(float));
+    }
+}
+
+void bee::RandomStream::NextBatch(float* out, const float min, const float scale)
+{
+#ifdef BEE_RANDOM_SSE2
+    __m128i s0 = _mm_load_si128(reinterpret_cast<const __m128i*>(m_lanes[0]));
+    __m128i s1 = _mm_load_si128(reinterpret_cast<const __m128i*>(m_lanes[1]));
+    __m128i s2 = _mm_load_si128(reinterpret_cast<const __m128i*>(m_lanes[2]));
+    __m128i s3 = _mm_load_si128(reinterpret_cast<const __m128i*>(m_lanes[3]));
+
+    const __m128i result = _mm_add_epi32(s0, s3);
+    const __m128i t = _mm_slli_epi32(s1, 9);
+    s2 = _mm_xor_si128(s2, s0);
+    s3 = _mm_xor_si128(s3, s1);
+    s1 = _mm_xor_si128(s1, s2);
+    s0 = _mm_xor_si128(s0, s3);
+    s2 = _mm_xor_si128(s2, t);
+    s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+    _mm_store_si128(reinterpret_cast<__m128i*>(m_lanes[0]), s0);
+    _mm_store_si128(reinterpret_cast<__m128i*>(m_lanes[1]), s1);
+    _mm_store_si128(reinterpret_cast<__m128i*>(m_lanes[2]), s2);
+    _mm_store_si128(reinterpret_cast<__m128i*>(m_lanes[3]), s3);
+
+    // after the shift the values fit in 24 bits, so the signed conversion is exact
+    const __m128 unit = _mm_cvtepi32_ps(_mm_srli_epi32(result, 8));
+    _mm_storeu_ps(out, _mm_add_ps(_mm_set1_ps(min), _mm_mul_ps(unit, _mm_set1_ps(scale))));
+#else
+    for (int lane = 0; lane < 4; lane++)
+    {
+        uint32_t& s0 = m_lanes[0][lane];
+        uint32_t& s1 = m_lanes[1][lane];
+        uint32_t& s2 = m_lanes[2][lane];
+        uint32_t& s3 = m_lanes[3][lane];
+
+        const uint32_t result = s0 + s3;
+        const uint32_t t = s1 << 9;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = RotateLeft(s3, 11);
+
+        out[lane] = min + static_cast<float>(result >> 8) * scale;
+    }
+#endif
+}
+
+void bee::SetThreadRandomSeed(const uint64_t seed) { g_threadSeed = seed; }
+
+bee::RandomStream& bee::ThreadRandomStream()
+{
+    thread_local RandomStream stream(g_threadSeed.load(), g_nextThreadStream.fetch_add(1));
+    return stream;
+}
@@ -19,6 +19,7 @@
 #include "resource_managers/ResourceManager.h"
 #include "ecs/components/compact_includes/AllComponents.h"
 #include "tools/MainMenuBar.h"
+#include "tools/SmallVector.h"
 
 void bee::Serializer::Serialize() const
 {
@@ -42,6 +43,11 @@ void bee::Serializer::Serialize() const
     {
         registry.destroy(ability);
     }
+    auto pooledAbilityView = registry.view<PooledAbilityComponent>();
+    for (auto& pooledAbility : pooledAbilityView)
+    {
+        registry.destroy(pooledAbility);
+    }
 
     std::ofstream outFile(m_serializationFileName);
     cereal::JSONOutputArchive outArchive(outFile);
@@ -65,7 +71,12 @@ void bee::Serializer::Serialize() const
         .get<PlayerStatsComponent>(outArchive)
         .get<AbilitiesOnPlayerComponent>(outArchive);
 
-    outArchive(cereal::make_nvp("savedAbilities", Engine.ResourceManager().GetAbilityManager().m_abilities));
+    // abilities are saved by name, their IDs are only valid until the manager is destroyed
+    std::unordered_map<std::string, AbilitySettings> savedAbilities;
+    Engine.ResourceManager().GetAbilityManager().ForEach(
+        [&savedAbilities](AbilityID, const std::string& name, const AbilitySettings& settings)
+        { savedAbilities.emplace(name, settings); });
+    outArchive(cereal::make_nvp("savedAbilities", savedAbilities));
     outArchive(cereal::make_nvp("viewFlags", Engine.MainMenuBar().GetFlags()));
 }
 
@@ -102,11 +113,34 @@ void bee::Serializer::Deserialize() const
             Engine.ResourceManager().GetModelManager().AddEntity(filePath, entity);
         }
 
-        inArchive(Engine.ResourceManager().GetAbilityManager().m_abilities);
+        std::unordered_map<std::string, AbilitySettings> savedAbilities;
+        inArchive(savedAbilities);
+        for (const auto& [name, settings] : savedAbilities)
+        {
+            Engine.ResourceManager().GetAbilityManager().Add(name, settings);
+        }
         inArchive(Engine.MainMenuBar().m_windowsToDisplayFlags);
     }
 }
 
+bool bee::Serializer::DeserializeAbilities(AbilityManager& abilityManager) const
+{
+    if (!std::filesystem::exists(m_serializationFileName))
+        return false;
+
+    std::ifstream inFile(m_serializationFileName);
+    cereal::JSONInputArchive inArchive(inFile);
+
+    // looked up by name, the entities before it are skipped
+    std::unordered_map<std::string, AbilitySettings> savedAbilities;
+    inArchive(cereal::make_nvp("savedAbilities", savedAbilities));
+    for (const auto& [name, settings] : savedAbilities)
+    {
+        abilityManager.Add(name, settings);
+    }
+    return true;
+}
+
 bool bee::Serializer::IsThereACerealFile() const
 {
     if (std::filesystem::exists(m_serializationFileName))
@@ -149,6 +183,29 @@ void serialize(Archive& archive, glm::mat4& a)
     archive(a[0], a[1], a[2], a[3]);
 }
 
+// written like a std::vector, so scenes saved before the components used SmallVector still load
+template <class Archive, typename T, size_t N>
+void save(Archive& archive, const bee::SmallVector<T, N>& a)
+{
+    archive(make_size_tag(static_cast<size_type>(a.size())));
+    for (const T& value : a)
+    {
+        archive(value);
+    }
+}
+
+template <class Archive, typename T, size_t N>
+void load(Archive& archive, bee::SmallVector<T, N>& a)
+{
+    size_type size;
+    archive(make_size_tag(size));
+    a.resize(static_cast<size_t>(size));
+    for (T& value : a)
+    {
+        archive(value);
+    }
+}
+
 template <class Archive>
 void serialize(Archive& archive, xsr::handle& a)
 {
@@ -212,13 +269,38 @@ void serialize(Archive& archive, bee::TransformComponent& a)
 template <class Archive>
 void serialize(Archive& archive, bee::EmitterComponent& a)
 {
-    archive(a.particlesPerSecond, a.endless, a.lifeSpan, a.currentLife);
+    archive(a.particlesPerSecond, a.endless, a.lifeSpan, a.currentLife, a.stateless);
+}
+
+template <class Archive, typename T>
+void serialize(Archive& archive, bee::CurveKey<T>& a)
+{
+    archive(a.time, a.value);
+}
+
+template <class Archive, typename T>
+void serialize(Archive& archive, bee::Curve<T>& a)
+{
+    archive(a.keys);
 }
 
 template <class Archive>
-void serialize(Archive& archive, bee::ParticleConfigComponent& a)
+void save(Archive& archive, const bee::ParticleConfigComponent& a)
 {
-    archive(a.gravity, a.dir, a.speed, a.colorBegin, a.colorEnd, a.scaleBegin, a.scaleEnd, a.lifeSpan);
+    archive(
+        a.gravity, a.dir, a.speed, a.colorGradient, a.scaleCurve, a.lifeSpan,
+        static_cast<std::underlying_type_t<bee::ParticleCollision>>(a.collision), a.collideWithBodies, a.groundHeight,
+        a.restitution);
+}
+
+template <class Archive>
+void load(Archive& archive, bee::ParticleConfigComponent& a)
+{
+    std::underlying_type_t<bee::ParticleCollision> collision;
+    archive(
+        a.gravity, a.dir, a.speed, a.colorGradient, a.scaleCurve, a.lifeSpan, collision, a.collideWithBodies,
+        a.groundHeight, a.restitution);
+    a.collision = static_cast<bee::ParticleCollision>(collision);
 }
 
 template <class Archive>
@@ -289,10 +371,31 @@ void load(Archive& archive, bee::PlayerStatsComponent& a)
     a.currentReceivedDamageReduction = a.baseReceivedDamageReduction;
 }
 
+using AbilityInputs = std::pair<std::optional<bee::Input::KeyboardKey>, std::optional<bee::Input::GamepadButton>>;
+
+template <class Archive>
+void save(Archive& archive, const bee::AbilitiesOnPlayerComponent& a)
+{
+    const auto& abilityManager = bee::Engine.ResourceManager().GetAbilityManager();
+    std::unordered_map<std::string, AbilityInputs> abilityNamesToInputsMap;
+    for (const auto& [abilityID, inputs] : a.abilityIDsToInputsMap)
+    {
+        abilityNamesToInputsMap.emplace(abilityManager.GetName(abilityID), inputs);
+    }
+    archive(abilityNamesToInputsMap, a.maxNumberOfAbilities);
+}
+
 template <class Archive>
-void serialize(Archive& archive, bee::AbilitiesOnPlayerComponent& a)
+void load(Archive& archive, bee::AbilitiesOnPlayerComponent& a)
 {
-    archive(a.abilityNamesToInputsMap, a.maxNumberOfAbilities);
+    std::unordered_map<std::string, AbilityInputs> abilityNamesToInputsMap;
+    archive(abilityNamesToInputsMap, a.maxNumberOfAbilities);
+    // entities are loaded before the abilities, so the names are interned before they have settings
+    auto& abilityManager = bee::Engine.ResourceManager().GetAbilityManager();
+    for (const auto& [name, inputs] : abilityNamesToInputsMap)
+    {
+        a.abilityIDsToInputsMap.emplace(abilityManager.Intern(name), inputs);
+    }
 }
 
 template <class Archive>
@@ -0,0 +1,8 @@
+#include "tools/SmallVector.h"
+
+std::pmr::memory_resource& bee::SmallVectorOverflowResource()
+{
+    // leaked on purpose, components in globals and statics are destroyed after a function local static would be
+    static auto* resource = new std::pmr::synchronized_pool_resource();
+    return *resource;
+}
@@ -1,6 +1,8 @@
 #include "tools/tools.hpp"
 #include <glm/gtx/euler_angles.hpp>
 
+#include "tools/Random.h"
+
 using namespace std;
 
 // Courtesy of: http://stackoverflow.com/questions/5878775/how-to-find-and-replace-string
@@ -57,12 +59,7 @@ bool bee::StringStartsWith(const string& subject, const std::string& prefix)
     return true;
 }
 
-constexpr int HALF_RAND = (RAND_MAX / 2);
-float bee::RandomFloatBtwnMinus1and1()
-{
-    int const rn = rand();
-    return static_cast<float>(rn - HALF_RAND) / static_cast<float>(HALF_RAND);
-}
+float bee::RandomFloatBtwnMinus1and1() { return ThreadRandomStream().Range(-1.f, 1.f); }
 
 glm::quat bee::GetQuatFromDegrees(glm::vec3 degrees)
 {